@@ -20,11 +20,33 @@ Args Args::register_opts(CLI::App& app) {
                    "Map URL prefix to directory. Usage: --static /url/path ./fs/path")
         ->expected(2);
 
+    app.add_option("--static-cache-mb", args.static_cache_mb,
+                   "Memory budget for cached static file content (0 disables)")
+        ->default_val(DEFAULT_STATIC_CACHE_MB);
+
     app.add_option("--access-log", args.access_log_path)->default_val(std::nullopt);
 
+    app.add_option("--access-log-format", args.access_log_format,
+                   "Access log format: clf, or binary (decode with ion-logcat)")
+        ->default_val("clf")
+        ->check(CLI::IsMember({"clf", "binary"}, CLI::ignore_case));
+
     app.add_flag("--cleartext", args.cleartext,
                  "Disables TLS and handles requests in HTTP/2 cleartext (h2c)");
 
+    app.add_flag("--ktls", args.ktls,
+                 "Offload TLS record encryption to the kernel (kTLS) when available");
+
+    app.add_option("--tls-session-cache", args.tls_session_cache,
+                   "Server-side TLS session cache entries, for clients without ticket support "
+                   "(0 disables)")
+        ->default_val(0);
+
+    app.add_option("--handshake-threads", args.handshake_threads,
+                   "Worker threads for TLS handshakes, keeping them off the event loop "
+                   "(0 disables)")
+        ->default_val(0);
+
     app.add_option("--tls-cert-path", args.cert_path, "Path to certificate file for TLS")
         ->envname("ION_TLS_CERT_PATH");
 
@@ -39,6 +61,46 @@ Args Args::register_opts(CLI::App& app) {
     app.add_flag("--status-page", args.status_page,
                  "Adds page (/_ion/status) displaying server status");
 
+    app.add_flag("--metrics-page", args.metrics_page,
+                 "Adds endpoint (/_ion/metrics) exposing metrics in Prometheus text format");
+
+    // the standard OpenTelemetry SDK environment variables are honoured as well
+    const ion::app::TelemetryConfig telemetry_defaults{};
+    app.add_option("--trace-sample-ratio", args.trace_sample_ratio,
+                   "Fraction of new traces to record; requests with a sampled parent are always "
+                   "recorded")
+        ->envname("OTEL_TRACES_SAMPLER_ARG")
+        ->default_val(1.0)
+        ->check(CLI::Range(0.0, 1.0));
+
+    app.add_option("--trace-queue-size", args.trace_queue_size,
+                   "Ended spans buffered for export before new ones are dropped")
+        ->envname("OTEL_BSP_MAX_QUEUE_SIZE")
+        ->default_val(telemetry_defaults.max_queue_size)
+        ->check(CLI::PositiveNumber);
+
+    app.add_option("--trace-batch-size", args.trace_batch_size,
+                   "Maximum spans sent in one export request")
+        ->envname("OTEL_BSP_MAX_EXPORT_BATCH_SIZE")
+        ->default_val(telemetry_defaults.max_export_batch_size)
+        ->check(CLI::PositiveNumber);
+
+    app.add_option("--trace-export-interval-ms", args.trace_export_interval_ms,
+                   "Delay between span exports")
+        ->envname("OTEL_BSP_SCHEDULE_DELAY")
+        ->default_val(telemetry_defaults.export_interval.count());
+
+    app.add_option("--trace-export-timeout-ms", args.trace_export_timeout_ms,
+                   "Time allowed for one span export request")
+        ->envname("OTEL_BSP_EXPORT_TIMEOUT")
+        ->default_val(telemetry_defaults.export_timeout.count());
+
+    app.add_option("--metric-export-interval-ms", args.metric_export_interval_ms,
+                   "Delay between metric exports")
+        ->envname("OTEL_METRIC_EXPORT_INTERVAL")
+        ->default_val(telemetry_defaults.metric_export_interval.count())
+        ->check(CLI::PositiveNumber);
+
     app.set_version_flag("-v,--version", std::string(ion::BUILD_VERSION));
 
     return args;
@@ -57,9 +119,20 @@ spdlog::level::level_enum Args::log_level_enum() const {
     throw CLI::ValidationError("Invalid log level: " + log_level);
 }
 
+ion::AccessLogFormat Args::access_log_format_enum() const {
+    if (access_log_format == "binary") {
+        return ion::AccessLogFormat::Binary;
+    }
+    return ion::AccessLogFormat::Clf;
+}
+
 ion::ServerConfiguration Args::to_server_config() const {
     auto config = ion::ServerConfiguration{};
     config.cleartext = cleartext;
+    config.tls.ktls = ktls;
+    config.tls.session_cache_size = tls_session_cache;
+    config.handshake_threads = handshake_threads;
+    config.trace_sample_ratio = trace_sample_ratio;
     if (!cert_path.empty()) {
         config.cert_path = cert_path;
     }
@@ -69,3 +142,13 @@ ion::ServerConfiguration Args::to_server_config() const {
     config.key_path = key_path;
     return config;
 }
+
+ion::app::TelemetryConfig Args::to_telemetry_config() const {
+    return ion::app::TelemetryConfig{
+        .max_queue_size = trace_queue_size,
+        .max_export_batch_size = trace_batch_size,
+        .export_interval = std::chrono::milliseconds{trace_export_interval_ms},
+        .export_timeout = std::chrono::milliseconds{trace_export_timeout_ms},
+        .metric_export_interval = std::chrono::milliseconds{metric_export_interval_ms},
+    };
+}
@@ -4,25 +4,42 @@
 #include <CLI/App.hpp>
 #include <CLI/Formatter.hpp>
 
+#include "access_log.h"
 #include "server_config.h"
+#include "telemetry.h"
 
 static constexpr uint16_t DEFAULT_PORT = 8443;
 static constexpr std::string_view DEFAULT_LOG_LEVEL = "info";
+static constexpr size_t DEFAULT_STATIC_CACHE_MB = 64;
 
 class Args {
    public:
     uint16_t port{DEFAULT_PORT};
     std::string log_level{DEFAULT_LOG_LEVEL};
     std::vector<std::string> static_map;
+    size_t static_cache_mb{DEFAULT_STATIC_CACHE_MB};
     std::string access_log_path{};
+    std::string access_log_format{"clf"};
     bool cleartext{};
+    bool ktls{};
+    size_t tls_session_cache{};
+    size_t handshake_threads{};
     std::string cert_path{};
     std::string key_path{};
     bool under_test{};
     std::string status_404_file_path{};
     bool status_page{};
+    bool metrics_page{};
+    double trace_sample_ratio{1.0};
+    size_t trace_queue_size{};
+    size_t trace_batch_size{};
+    uint32_t trace_export_interval_ms{};
+    uint32_t trace_export_timeout_ms{};
+    uint32_t metric_export_interval_ms{};
 
     static Args register_opts(CLI::App& app);
     [[nodiscard]] spdlog::level::level_enum log_level_enum() const;
+    [[nodiscard]] ion::AccessLogFormat access_log_format_enum() const;
     [[nodiscard]] ion::ServerConfiguration to_server_config() const;
+    [[nodiscard]] ion::app::TelemetryConfig to_telemetry_config() const;
 };
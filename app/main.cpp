@@ -8,16 +8,20 @@
 #include "access_log.h"
 #include "args.h"
 #include "http2_server.h"
+#include "metrics_page.h"
 #include "proc_ctrl.h"
 #include "signal_handler.h"
-#include "spdlog/sinks/basic_file_sink.h"
 #include "status_page.h"
 #include "telemetry.h"
 #include "test_routes.h"
 #include "trace_id_flag.h"
 
-void run_server(const Args& args) {
-    ion::Http2Server server{args.to_server_config()};
+void run_server(const Args& args, bool tracing_enabled) {
+    auto config = args.to_server_config();
+    if (!tracing_enabled) {
+        config.trace_sample_ratio = 0.0;
+    }
+    ion::Http2Server server{config};
     auto signal_handler = SignalHandler::setup(server);
     auto& router = server.router();
 
@@ -28,7 +32,12 @@ void run_server(const Args& args) {
 
     if (args.status_page) {
         spdlog::info("status page enabled: /_ion/status");
-        StatusPage::add_status_page(router);
+        StatusPage::add_status_page(server);
+    }
+
+    if (args.metrics_page) {
+        spdlog::info("metrics page enabled: /_ion/metrics");
+        MetricsPage::add_metrics_page(server);
     }
 
     if (args.static_map.size() == 2) {
@@ -36,7 +45,9 @@ void run_server(const Args& args) {
         auto& filesystem_root = args.static_map[1];
 
         spdlog::info("serving static files at '{}' -> '{}'", url_prefix, filesystem_root);
-        auto sth = std::make_unique<ion::StaticFileHandler>(url_prefix, filesystem_root);
+        auto sth = std::make_unique<ion::StaticFileHandler>(
+            url_prefix, filesystem_root,
+            ion::StaticFileCacheConfig{.max_bytes = args.static_cache_mb * 1024 * 1024});
         router.add_static_handler(std::move(sth));
     }
 
@@ -59,17 +70,15 @@ void run_server(const Args& args) {
     server.start(args.port);
 }
 
-void setup_access_logs(const std::string& log_path) {
+void setup_access_logs(const std::string& log_path, ion::AccessLogFormat format) {
     if (log_path.empty()) {
         return;
     }
 
     try {
-        auto logger = spdlog::basic_logger_mt(ion::AccessLog::ACCESS_LOGGER_NAME, log_path);
-        logger->set_pattern("%v");
-        logger->flush_on(spdlog::level::info);
+        ion::AccessLog::open(log_path, format);
         spdlog::info("writing access logs to {}", log_path);
-    } catch (const spdlog::spdlog_ex& e) {
+    } catch (const std::runtime_error& e) {
         spdlog::error("failed to setup access logs: {}", e.what());
     }
 }
@@ -80,10 +89,10 @@ void enable_no_new_privs_on_linux() {
 #endif
 }
 
-std::unique_ptr<ion::app::Telemetry> configure_telemetry() {
+std::unique_ptr<ion::app::Telemetry> configure_telemetry(const Args& args) {
     const char* otel_disabled = std::getenv("OTEL_SDK_DISABLED");
     if (!otel_disabled || std::string_view(otel_disabled) != "true") {
-        return std::make_unique<ion::app::Telemetry>("ion-server");
+        return std::make_unique<ion::app::Telemetry>(args.to_telemetry_config());
     }
     spdlog::info("OpenTelemetry disabled.");
     return nullptr;
@@ -98,22 +107,30 @@ int main(int argc, char* argv[]) {
         return app.exit(e);
     }
 
-    auto telemetry = configure_telemetry();
+    auto telemetry = configure_telemetry(args);
 
     auto formatter = std::make_unique<spdlog::pattern_formatter>();
     formatter->add_flag<ion::app::TraceIdFlag>('J');
     formatter->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%l] %J%v");
     spdlog::set_formatter(std::move(formatter));
     spdlog::set_level(args.log_level_enum());
+    if (args.log_level_enum() < SPDLOG_ACTIVE_LEVEL) {
+        spdlog::warn("this build has no {} logging (ION_LOG_ACTIVE_LEVEL is {})",
+                     spdlog::level::to_string_view(args.log_level_enum()),
+                     spdlog::level::to_string_view(
+                         static_cast<spdlog::level::level_enum>(SPDLOG_ACTIVE_LEVEL)));
+    }
 
     spdlog::info("ion {} started ⚡️", ion::BUILD_VERSION);
     try {
         enable_no_new_privs_on_linux();
-        setup_access_logs(args.access_log_path);
-        run_server(args);
+        setup_access_logs(args.access_log_path, args.access_log_format_enum());
+        run_server(args, telemetry != nullptr);
+        ion::AccessLog::close();
         spdlog::info("exiting");
         return EXIT_SUCCESS;
     } catch (const std::exception& e) {
+        ion::AccessLog::close();
         spdlog::critical("fatal error: {}", e.what());
         return EXIT_FAILURE;
     }
@@ -0,0 +1,97 @@
+#include "metrics_page.h"
+
+#include <array>
+#include <charconv>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hpack/header_block_encoder.h"
+#include "http_response.h"
+#include "prometheus_text.h"
+#include "server_metrics.h"
+#include "server_stats.h"
+
+// le bounds of the exported latency buckets, in microseconds
+static constexpr std::array<uint64_t, 14> LATENCY_BOUNDS_US{
+    100, 250, 500, 1000, 2500, 5000, 10'000, 25'000, 50'000, 100'000, 250'000, 500'000,
+    1'000'000, 5'000'000};
+
+static void render_metrics(const ion::Http2Server& server, const ServerStats& stats,
+                           std::vector<uint8_t>& out) {
+    using ion::PrometheusLabel;
+    ion::PrometheusTextWriter writer{out};
+
+    const auto uptime = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                                      stats.start_time);
+    writer.header("ion_uptime_seconds", "gauge", "Time since the server started");
+    writer.sample("ion_uptime_seconds", uptime.count());
+
+    const auto metrics = ion::ServerMetrics::snapshot();
+    writer.header("ion_connections_active", "gauge", "Open client connections");
+    writer.sample("ion_connections_active", metrics.active_connections);
+    writer.header("ion_streams_active", "gauge", "Streams with a response still being sent");
+    writer.sample("ion_streams_active", metrics.active_streams);
+    writer.header("ion_bytes_received_total", "counter", "Bytes read from client connections");
+    writer.sample("ion_bytes_received_total", metrics.bytes_received);
+    writer.header("ion_bytes_sent_total", "counter", "Bytes written to client connections");
+    writer.sample("ion_bytes_sent_total", metrics.bytes_sent);
+
+    writer.header("ion_hpack_dynamic_table_bytes", "gauge",
+                  "Size of the HPACK dynamic tables of open connections");
+    const std::array decoder{PrometheusLabel{"table", "decoder"}};
+    writer.sample("ion_hpack_dynamic_table_bytes", metrics.hpack_decoder_table_bytes, decoder);
+    const std::array encoder{PrometheusLabel{"table", "encoder"}};
+    writer.sample("ion_hpack_dynamic_table_bytes", metrics.hpack_encoder_table_bytes, encoder);
+
+    if (const auto tls = server.tls_handshake_stats()) {
+        writer.header("ion_tls_handshakes_total", "counter", "Completed TLS handshakes");
+        const std::array full{PrometheusLabel{"resumed", "false"}};
+        writer.sample("ion_tls_handshakes_total", tls->full, full);
+        const std::array resumed{PrometheusLabel{"resumed", "true"}};
+        writer.sample("ion_tls_handshakes_total", tls->resumed, resumed);
+    }
+
+    const auto snapshot = ion::ServerMetrics::request_snapshot();
+    writer.header("ion_http_requests_total", "counter", "Responses sent, by status code");
+    std::array<char, 8> code_text{};
+    for (size_t code = 0; code < snapshot.status_codes.size(); code++) {
+        if (const auto count = snapshot.status_codes[code]; count != 0) {
+            const auto end =
+                std::to_chars(code_text.data(), code_text.data() + code_text.size(), code).ptr;
+            const auto code_label =
+                code == 0 ? std::string_view{"other"} : std::string_view{code_text.data(), end};
+            const std::array label{PrometheusLabel{"code", code_label}};
+            writer.sample("ion_http_requests_total", count, label);
+        }
+    }
+
+    writer.histogram_seconds("ion_http_request_duration_seconds",
+                             "Time taken by route handlers to produce a response",
+                             snapshot.latency, LATENCY_BOUNDS_US);
+}
+
+void MetricsPage::add_metrics_page(ion::Http2Server& server) {
+    const auto headers =
+        std::make_shared<const ion::PreEncodedHeaders>(ion::HeaderBlockEncoder::pre_encode({
+            {"content-type", std::string{ion::PrometheusTextWriter::CONTENT_TYPE}},
+            {"cache-control", "no-store"},
+        }));
+
+    auto& stats = ServerStats::instance();
+    server.router().add_route("/_ion/metrics", "GET", [&server, &stats, headers](const auto&) {
+        // rendered straight into the body and handed over as shared_body; the next scrape on
+        // this thread reuses it (and its capacity) once the previous response has been sent
+        thread_local std::shared_ptr<std::vector<uint8_t>> body{};
+        if (!body || body.use_count() > 1) {
+            body = std::make_shared<std::vector<uint8_t>>();
+        }
+        body->clear();
+        render_metrics(server, stats, *body);
+        return ion::HttpResponse{
+            .status_code = 200,
+            .pre_encoded_headers = headers,
+            .shared_body = body,
+        };
+    });
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include "http2_server.h"
+
+class MetricsPage {
+   public:
+    // serves /_ion/metrics in the Prometheus text format
+    static void add_metrics_page(ion::Http2Server& server);
+};
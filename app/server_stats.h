@@ -1,16 +1,13 @@
 #pragma once
 #include <chrono>
-#include <map>
-
-#include "router.h"
+#include <string>
 
+// Identity and start time of this server process, shown by the status and metrics pages. Request
+// counts and latencies come from ion::ServerMetrics::request_snapshot().
 class ServerStats {
    public:
-    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
-    uint64_t total_requests{0};
-    std::map<uint16_t, uint64_t> status_codes{};
-    int64_t total_duration_us{0};
-    std::string server_id = generate_id();
+    const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    const std::string server_id = generate_id();
 
     ServerStats() = default;
     ~ServerStats() = default;
@@ -23,8 +20,6 @@ class ServerStats {
         return s;
     }
 
-    static ion::Middleware middleware();
-
    private:
     static std::string generate_id();
 };
@@ -6,7 +6,9 @@
 #include <sstream>
 #include <string>
 
+#include "hpack/header_block_encoder.h"
 #include "http_response.h"
+#include "server_metrics.h"
 #include "server_stats.h"
 #include "version.h"
 
@@ -30,20 +32,30 @@ std::string StatusPage::format_duration(uint64_t total_seconds) {
     return ss.str();
 }
 
-void StatusPage::add_status_page(ion::Router& router) {
-    router.add_middleware(ServerStats::middleware());
-
+void StatusPage::add_status_page(ion::Http2Server& server) {
+    auto& router = server.router();
     auto& stats = ServerStats::instance();
     spdlog::info("instance id: {}", stats.server_id);
 
-    router.add_route("/_ion/status", "GET", [&stats](const auto&) {
+    const auto headers =
+        std::make_shared<const ion::PreEncodedHeaders>(ion::HeaderBlockEncoder::pre_encode({
+            {"content-type", "text/html; charset=utf-8"},
+            {"cache-control", "no-store"},
+        }));
+
+    router.add_route("/_ion/status", "GET", [&server, &stats, headers](const auto&) {
         const auto now = std::chrono::steady_clock::now();
         const auto uptime_sec =
             std::chrono::duration_cast<std::chrono::seconds>(now - stats.start_time).count();
         const std::string uptime = format_duration(uptime_sec);
 
-        const uint64_t total = stats.total_requests;
-        const double avg_lat = total > 0 ? (double)stats.total_duration_us / total / 1000.0 : 0.0;
+        const auto snapshot = ion::ServerMetrics::request_snapshot();
+        const auto& latency = snapshot.latency;
+        const uint64_t total = snapshot.total_requests;
+        const double avg_lat = total > 0 ? (double)latency.sum() / total / 1000.0 : 0.0;
+        const auto latency_ms = [&latency](double quantile) {
+            return static_cast<double>(latency.value_at_quantile(quantile)) / 1000.0;
+        };
 
         std::stringstream html;
         html << R"html(
@@ -208,20 +220,56 @@ void StatusPage::add_status_page(ion::Router& router) {
             <div class="stat-item"><span class="label">Uptime</span><span class="value">)html"
              << uptime << R"html(</span></div>
             <div class="stat-item"><span class="label">Requests</span><span class="value">)html"
-             << stats.total_requests << R"html(</span></div>
+             << total << R"html(</span></div>
             <div class="stat-item"><span class="label">Avg Latency</span><span class="value">)html"
              << std::fixed << std::setprecision(2) << avg_lat << R"html(ms</span></div>
+            <div class="stat-item"><span class="label">p50 / p90</span><span class="value">)html"
+             << latency_ms(0.5) << " / " << latency_ms(0.9) << R"html(ms</span></div>
+            <div class="stat-item"><span class="label">p99 / p99.9</span><span class="value">)html"
+             << latency_ms(0.99) << " / " << latency_ms(0.999) << R"html(ms</span></div>)html";
+
+        const auto conn_mem = server.connection_memory_stats();
+        const auto avg_conn_kib =
+            conn_mem.connections > 0
+                ? static_cast<double>(conn_mem.total_bytes) / conn_mem.connections / 1024.0
+                : 0.0;
+        html << R"html(
+            <div class="stat-item"><span class="label">Connections</span><span class="value">)html"
+             << conn_mem.connections << R"html(</span></div>
+            <div class="stat-item"><span class="label">Memory / Conn</span><span class="value">)html"
+             << std::setprecision(1) << avg_conn_kib << R"html( KiB</span></div>)html";
+
+        if (const auto tls = server.tls_handshake_stats()) {
+            const auto handshakes = tls->full + tls->resumed;
+            const double resumed_pct =
+                handshakes > 0 ? 100.0 * static_cast<double>(tls->resumed) / handshakes : 0.0;
+            html << R"html(
+            <div class="stat-item"><span class="label">TLS Handshakes</span><span class="value">)html"
+                 << handshakes << R"html(</span></div>
+            <div class="stat-item"><span class="label">TLS Resumed</span><span class="value">)html"
+                 << tls->resumed << " (" << std::setprecision(1) << resumed_pct
+                 << R"html(%)</span></div>)html";
+        }
+
+        html << R"html(
         </div>
 
         <h3>HTTP Status Codes</h3>
         <div class="code-list">)html";
 
-        if (stats.status_codes.empty()) {
+        if (total == 0) {
             html << "<em>No requests yet</em>";
         } else {
-            for (auto const& [code, count] : stats.status_codes) {
-                html << "<div class='code-badge'><span class='code-num'>" << code << "</span>"
-                     << count << "</div>";
+            for (size_t code = 0; code < snapshot.status_codes.size(); code++) {
+                if (const auto count = snapshot.status_codes[code]; count != 0) {
+                    html << "<div class='code-badge'><span class='code-num'>";
+                    if (code == 0) {
+                        html << "other";
+                    } else {
+                        html << code;
+                    }
+                    html << "</span>" << count << "</div>";
+                }
             }
         }
 
@@ -240,8 +288,7 @@ void StatusPage::add_status_page(ion::Router& router) {
         return ion::HttpResponse{
             .status_code = 200,
             .body = std::vector<uint8_t>{body_str.begin(), body_str.end()},
-            .headers = {{"content-type", "text/html; charset=utf-8"},
-                        {"cache-control", "no-store"}},
+            .pre_encoded_headers = headers,
         };
     });
 }
@@ -1,9 +1,9 @@
 #pragma once
-#include "router.h"
+#include "http2_server.h"
 
 class StatusPage {
    public:
-    static void add_status_page(ion::Router& router);
+    static void add_status_page(ion::Http2Server& server);
 
    private:
     static std::string format_duration(uint64_t total_seconds);
@@ -2,33 +2,151 @@
 
 #include <opentelemetry/exporters/otlp/otlp_http_exporter_factory.h>
 #include <opentelemetry/exporters/otlp/otlp_http_exporter_options.h>
-#include <opentelemetry/nostd/shared_ptr.h>
+#include <opentelemetry/exporters/otlp/otlp_http_metric_exporter_factory.h>
+#include <opentelemetry/exporters/otlp/otlp_http_metric_exporter_options.h>
+#include <opentelemetry/metrics/noop.h>
+#include <opentelemetry/metrics/provider.h>
+#include <opentelemetry/sdk/metrics/export/periodic_exporting_metric_reader_factory.h>
+#include <opentelemetry/sdk/metrics/export/periodic_exporting_metric_reader_options.h>
+#include <opentelemetry/sdk/metrics/meter_provider_factory.h>
+#include <opentelemetry/sdk/metrics/view/view_registry_factory.h>
 #include <opentelemetry/sdk/resource/resource.h>
-#include <opentelemetry/sdk/trace/simple_processor_factory.h>
+#include <opentelemetry/sdk/trace/batch_span_processor_factory.h>
+#include <opentelemetry/sdk/trace/batch_span_processor_options.h>
+#include <opentelemetry/sdk/trace/samplers/parent_factory.h>
+#include <opentelemetry/sdk/trace/samplers/always_on_factory.h>
 #include <opentelemetry/sdk/trace/tracer_provider_factory.h>
 #include <opentelemetry/trace/provider.h>
 
+#include <algorithm>
+#include <array>
+
+#include "server_metrics.h"
+
 namespace ion::app {
 
-Telemetry::Telemetry(const std::string& service_name) {
-    opentelemetry::exporter::otlp::OtlpHttpExporterOptions opts;
-    auto exporter = opentelemetry::exporter::otlp::OtlpHttpExporterFactory::Create(opts);
+namespace metrics_api = opentelemetry::metrics;
+
+namespace {
+
+enum class ObservableKind { Counter, UpDownCounter };
+
+struct ObservedMetric {
+    const char* name;
+    const char* description;
+    const char* unit;
+    ObservableKind kind;
+    int64_t (*read)(const ion::ServerMetricsSnapshot&);
+};
+
+constexpr std::array OBSERVED_METRICS{
+    ObservedMetric{"ion.connections.active", "Open client connections", "{connection}",
+                   ObservableKind::UpDownCounter,
+                   [](const auto& s) { return s.active_connections; }},
+    ObservedMetric{"ion.streams.active", "Streams with a response still being sent", "{stream}",
+                   ObservableKind::UpDownCounter, [](const auto& s) { return s.active_streams; }},
+    ObservedMetric{"ion.bytes.received", "Bytes read from client connections", "By",
+                   ObservableKind::Counter,
+                   [](const auto& s) { return static_cast<int64_t>(s.bytes_received); }},
+    ObservedMetric{"ion.bytes.sent", "Bytes written to client connections", "By",
+                   ObservableKind::Counter,
+                   [](const auto& s) { return static_cast<int64_t>(s.bytes_sent); }},
+    ObservedMetric{"ion.hpack.decoder.table.size",
+                   "Size of the HPACK decoder dynamic tables of open connections", "By",
+                   ObservableKind::UpDownCounter,
+                   [](const auto& s) { return s.hpack_decoder_table_bytes; }},
+    ObservedMetric{"ion.hpack.encoder.table.size",
+                   "Size of the HPACK encoder dynamic tables of open connections", "By",
+                   ObservableKind::UpDownCounter,
+                   [](const auto& s) { return s.hpack_encoder_table_bytes; }},
+};
+
+// runs on the metric reader's thread once per collection; state is the ObservedMetric
+void observe(metrics_api::ObserverResult result, void* state) {
+    const auto& metric = *static_cast<const ObservedMetric*>(state);
+    const auto value = metric.read(ion::ServerMetrics::snapshot());
+    opentelemetry::nostd::get<
+        opentelemetry::nostd::shared_ptr<metrics_api::ObserverResultT<int64_t>>>(result)
+        ->Observe(value);
+}
+
+}  // namespace
+
+Telemetry::Telemetry(const TelemetryConfig& config) : export_timeout_(config.export_timeout) {
+    opentelemetry::exporter::otlp::OtlpHttpExporterOptions exporter_opts;
+    exporter_opts.timeout = config.export_timeout;
+    auto exporter = opentelemetry::exporter::otlp::OtlpHttpExporterFactory::Create(exporter_opts);
 
-    auto processor =
-        opentelemetry::sdk::trace::SimpleSpanProcessorFactory::Create(std::move(exporter));
-    auto resource =
-        opentelemetry::sdk::resource::Resource::Create({{"service.name", service_name}});
-    auto provider = opentelemetry::sdk::trace::TracerProviderFactory::Create(std::move(processor),
-                                                                             std::move(resource));
+    opentelemetry::sdk::trace::BatchSpanProcessorOptions processor_opts;
+    processor_opts.max_queue_size = config.max_queue_size;
+    processor_opts.max_export_batch_size =
+        std::min(config.max_export_batch_size, config.max_queue_size);
+    processor_opts.schedule_delay_millis = config.export_interval;
+    auto processor = opentelemetry::sdk::trace::BatchSpanProcessorFactory::Create(
+        std::move(exporter), processor_opts);
 
-    std::shared_ptr<opentelemetry::trace::TracerProvider> api_provider(std::move(provider));
+    // the sample ratio is applied by the server before a span is started (see RequestSampler),
+    // so every span that reaches the SDK is recorded unless its parent says otherwise
+    auto sampler = opentelemetry::sdk::trace::ParentBasedSamplerFactory::Create(
+        opentelemetry::sdk::trace::AlwaysOnSamplerFactory::Create());
+    const auto resource =
+        opentelemetry::sdk::resource::Resource::Create({{"service.name", config.service_name}});
+    provider_ = opentelemetry::sdk::trace::TracerProviderFactory::Create(
+        std::move(processor), resource, std::move(sampler));
+
+    std::shared_ptr<opentelemetry::trace::TracerProvider> api_provider(provider_);
     opentelemetry::trace::Provider::SetTracerProvider(api_provider);
+
+    install_meter_provider(config, resource);
+}
+
+void Telemetry::install_meter_provider(const TelemetryConfig& config,
+                                       const opentelemetry::sdk::resource::Resource& resource) {
+    opentelemetry::exporter::otlp::OtlpHttpMetricExporterOptions exporter_opts;
+    exporter_opts.timeout = config.export_timeout;
+    auto exporter =
+        opentelemetry::exporter::otlp::OtlpHttpMetricExporterFactory::Create(exporter_opts);
+
+    // the SDK rejects (and replaces with its defaults) a timeout that isn't below the interval
+    opentelemetry::sdk::metrics::PeriodicExportingMetricReaderOptions reader_opts;
+    reader_opts.export_interval_millis = config.metric_export_interval;
+    reader_opts.export_timeout_millis =
+        std::min(config.export_timeout, config.metric_export_interval / 2);
+    auto reader = opentelemetry::sdk::metrics::PeriodicExportingMetricReaderFactory::Create(
+        std::move(exporter), reader_opts);
+
+    meter_provider_ = opentelemetry::sdk::metrics::MeterProviderFactory::Create(
+        opentelemetry::sdk::metrics::ViewRegistryFactory::Create(), resource);
+    meter_provider_->AddMetricReader(std::move(reader));
+
+    std::shared_ptr<metrics_api::MeterProvider> api_provider(meter_provider_);
+    metrics_api::Provider::SetMeterProvider(api_provider);
+
+    const auto meter = meter_provider_->GetMeter("ion");
+    for (const auto& metric : OBSERVED_METRICS) {
+        auto instrument =
+            metric.kind == ObservableKind::Counter
+                ? meter->CreateInt64ObservableCounter(metric.name, metric.description,
+                                                      metric.unit)
+                : meter->CreateInt64ObservableUpDownCounter(metric.name, metric.description,
+                                                            metric.unit);
+        instrument->AddCallback(observe, const_cast<ObservedMetric*>(&metric));
+        observables_.push_back(std::move(instrument));
+    }
 }
 
 Telemetry::~Telemetry() {
     auto provider = std::static_pointer_cast<opentelemetry::trace::TracerProvider>(
         std::make_shared<opentelemetry::trace::NoopTracerProvider>());
     opentelemetry::trace::Provider::SetTracerProvider(provider);
+    // flushes the batch processor's queue
+    provider_->Shutdown(export_timeout_);
+
+    auto meter_provider = std::static_pointer_cast<metrics_api::MeterProvider>(
+        std::make_shared<metrics_api::NoopMeterProvider>());
+    metrics_api::Provider::SetMeterProvider(meter_provider);
+    // the periodic reader collects and exports once more before stopping
+    meter_provider_->Shutdown(export_timeout_);
 }
 
 }  // namespace ion::app
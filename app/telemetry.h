@@ -1,15 +1,51 @@
 #pragma once
+#include <opentelemetry/metrics/async_instruments.h>
+#include <opentelemetry/sdk/metrics/meter_provider.h>
+#include <opentelemetry/sdk/resource/resource.h>
+#include <opentelemetry/sdk/trace/tracer_provider.h>
+
+#include <chrono>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace ion::app {
 
+struct TelemetryConfig {
+    std::string service_name{"ion-server"};
+    // spans waiting for export; further spans are dropped while the queue is full
+    size_t max_queue_size{2048};
+    size_t max_export_batch_size{512};
+    std::chrono::milliseconds export_interval{5000};
+    std::chrono::milliseconds export_timeout{10000};
+    std::chrono::milliseconds metric_export_interval{10000};
+};
+
+// Installs the global tracer and meter providers. Spans are queued when they end and exported in
+// batches from a background thread, so request handling never waits on the collector. Metrics
+// are collected and exported periodically: connection gauges and byte counters are read from
+// ServerMetrics' per-thread counters at collection time, and the request and handshake duration
+// histograms are recorded by the server.
 class Telemetry {
    public:
-    explicit Telemetry(const std::string& service_name);
+    explicit Telemetry(const TelemetryConfig& config);
+    // exports queued spans and a final round of metrics (bounded by the export timeout) before
+    // uninstalling the providers
     ~Telemetry();
 
     Telemetry(const Telemetry&) = delete;
     Telemetry& operator=(const Telemetry&) = delete;
+
+   private:
+    std::chrono::milliseconds export_timeout_;
+    std::shared_ptr<opentelemetry::sdk::trace::TracerProvider> provider_;
+    std::shared_ptr<opentelemetry::sdk::metrics::MeterProvider> meter_provider_;
+    // observed through callbacks, so they live as long as the provider
+    std::vector<opentelemetry::nostd::shared_ptr<opentelemetry::metrics::ObservableInstrument>>
+        observables_{};
+
+    void install_meter_provider(const TelemetryConfig& config,
+                                const opentelemetry::sdk::resource::Resource& resource);
 };
 
 }  // namespace ion::app
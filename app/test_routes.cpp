@@ -2,12 +2,20 @@
 
 #include "test_routes.h"
 
+#include <spdlog/spdlog.h>
+
 #include "proc_ctrl.h"
 
 void TestRoutes::add_test_routes(ion::Router& router) {
     router.add_route("/_tests/ok", "GET",
                      [](const auto&) { return ion::HttpResponse{.status_code = 200}; });
 
+    // logs at info from inside the request, so it's compiled into every build
+    router.add_route("/_tests/log", "GET", [](const auto&) {
+        spdlog::info("test route handled");
+        return ion::HttpResponse{.status_code = 200};
+    });
+
     router.add_route("/_tests/no_content", "GET",
                      [](const auto&) { return ion::HttpResponse{.status_code = 204}; });
 
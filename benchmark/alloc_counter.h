@@ -0,0 +1,5 @@
+#pragma once
+#include <cstdint>
+
+// Number of global operator new calls, aligned or not, made so far by the benchmark process.
+uint64_t allocation_count();
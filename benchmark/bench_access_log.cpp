@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <chrono>
+#include <string>
+
+#include "access_log_binary.h"
+
+// a mix of repeated paths and clients, as seen by a busy server
+static std::array<ion::AccessLogRecord, 64> sample_records() {
+    std::array<ion::AccessLogRecord, 64> records{};
+    auto time = std::chrono::system_clock::now();
+    for (size_t i = 0; i < records.size(); i++) {
+        auto& record = records[i];
+        record.time = time + std::chrono::milliseconds{i * 3};
+        record.status_code = i % 10 == 0 ? 404 : 200;
+        record.content_length = 512 + i * 37;
+        record.method.assign("GET");
+        record.client_ip.assign("10.0.0." + std::to_string(i % 8));
+        record.path.assign("/api/v1/products/" + std::to_string(i % 16));
+        record.referrer.assign("https://example.com/catalog");
+        record.user_agent.assign(
+            "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/605.1.15 (KHTML, like "
+            "Gecko) Version/17.0 Safari/605.1.15");
+    }
+    return records;
+}
+
+static void BM_AccessLog_FormatClf(benchmark::State& state) {
+    const auto records = sample_records();
+    std::string out{};
+    size_t bytes = 0;
+    for (auto _ : state) {
+        for (const auto& record : records) {
+            ion::AccessLog::format_clf(record, out);
+        }
+        bytes += out.size();
+        out.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * records.size());
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_AccessLog_FormatClf);
+
+static void BM_AccessLog_EncodeBinary(benchmark::State& state) {
+    const auto records = sample_records();
+    ion::BinaryAccessLogEncoder encoder{};
+    std::string out{};
+    encoder.begin_segment(out);
+    size_t bytes = 0;
+    for (auto _ : state) {
+        for (const auto& record : records) {
+            encoder.append(record, out);
+        }
+        encoder.finish_chunk(out);
+        bytes += out.size();
+        out.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * records.size());
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_AccessLog_EncodeBinary);
@@ -0,0 +1,140 @@
+#include <benchmark/benchmark.h>
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "alloc_counter.h"
+#include "hpack/header_block_encoder.h"
+#include "http2_conn.h"
+#include "http2_frames.h"
+#include "router.h"
+#include "transports/memory_transport.h"
+
+static constexpr std::string_view CLIENT_PREFACE{"PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"};
+static constexpr uint8_t FRAME_TYPE_HEADERS = 0x01;
+static constexpr uint8_t FRAME_TYPE_SETTINGS = 0x04;
+static constexpr uint8_t FLAG_END_STREAM = 0x01;
+static constexpr uint8_t FLAG_END_HEADERS = 0x04;
+
+static const std::vector<ion::HttpHeader> REQUEST_HEADERS = {
+    {":method", "GET"},
+    {":scheme", "https"},
+    {":authority", "localhost:8443"},
+    {":path", "/bench"},
+    {"user-agent", "h2load nghttp2/1.64.0"},
+    {"accept", "*/*"},
+    {"accept-encoding", "gzip, deflate"},
+};
+
+static void append_frame(std::vector<uint8_t>& out, uint8_t type, uint8_t flags,
+                         uint32_t stream_id, std::span<const uint8_t> payload) {
+    const ion::Http2FrameHeader header{.length = static_cast<uint32_t>(payload.size()),
+                                       .type = type,
+                                       .flags = flags,
+                                       .stream_id = stream_id};
+    std::array<uint8_t, ion::Http2FrameHeader::wire_size> header_bytes{};
+    header.serialize(header_bytes);
+    out.insert(out.end(), header_bytes.begin(), header_bytes.end());
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+// client preface, empty SETTINGS and `requests` HEADERS frames, HPACK encoded as a client would
+// across one connection (the first request populates the dynamic table, the rest reference it)
+static std::vector<uint8_t> record_client_stream(size_t requests) {
+    std::vector<uint8_t> out{CLIENT_PREFACE.begin(), CLIENT_PREFACE.end()};
+    append_frame(out, FRAME_TYPE_SETTINGS, 0, 0, {});
+
+    auto dynamic_table = ion::DynamicTable{4096};
+    auto encoder = ion::HeaderBlockEncoder{dynamic_table};
+    for (size_t i = 0; i < requests; i++) {
+        const auto block = encoder.encode(REQUEST_HEADERS);
+        append_frame(out, FRAME_TYPE_HEADERS, FLAG_END_HEADERS | FLAG_END_STREAM,
+                     static_cast<uint32_t>(2 * i + 1), block);
+    }
+    return out;
+}
+
+static ion::Router make_router() {
+    auto router = ion::Router{};
+    router.add_route("/bench", "GET", [](const ion::HttpRequest&) {
+        return ion::HttpResponse{.status_code = 200,
+                                 .body = {'o', 'k'},
+                                 .headers = {{"content-type", "text/plain"}}};
+    });
+    return router;
+}
+
+static void report(benchmark::State& state, uint64_t allocations, int64_t requests) {
+    state.SetItemsProcessed(requests);
+    state.counters["allocs_per_request"] =
+        benchmark::Counter(static_cast<double>(allocations) / static_cast<double>(requests));
+}
+
+// whole connection lifecycle: setup, preface, SETTINGS and N requests, amortised over N
+static void BM_Http2Connection_RecordedStream(benchmark::State& state) {
+    spdlog::set_level(spdlog::level::warn);
+    const auto requests = static_cast<size_t>(state.range(0));
+    const auto router = make_router();
+    const auto stream = record_client_stream(requests);
+
+    const auto allocations_before = allocation_count();
+    for (auto _ : state) {
+        auto transport = std::make_unique<ion::MemoryTransport>();
+        auto* memory_transport = transport.get();
+        memory_transport->feed(stream);
+        ion::Http2Connection conn{std::move(transport), "127.0.0.1", router};
+
+        if (conn.process() != ion::Http2ProcessResult::WantRead) {
+            state.SkipWithError("connection did not consume the recorded stream");
+            break;
+        }
+        benchmark::DoNotOptimize(memory_transport->output().data());
+    }
+    report(state, allocation_count() - allocations_before,
+           state.iterations() * static_cast<int64_t>(requests));
+}
+BENCHMARK(BM_Http2Connection_RecordedStream)->ArgName("requests")->Arg(1)->Arg(16)->Arg(256);
+
+// per-request cost on an established connection with a warm HPACK context, with every request
+// traced (sampled:1) or none (sampled:0)
+static void BM_Http2Connection_SteadyState(benchmark::State& state) {
+    spdlog::set_level(spdlog::level::warn);
+    const auto router = make_router();
+    // the second recorded request is the steady-state form, fully indexed
+    const auto warmup = record_client_stream(1);
+    auto request = std::vector<uint8_t>{};
+    {
+        auto dynamic_table = ion::DynamicTable{4096};
+        auto encoder = ion::HeaderBlockEncoder{dynamic_table};
+        encoder.encode(REQUEST_HEADERS);
+        append_frame(request, FRAME_TYPE_HEADERS, FLAG_END_HEADERS | FLAG_END_STREAM, 3,
+                     encoder.encode(REQUEST_HEADERS));
+    }
+
+    const auto sampler = ion::RequestSampler{state.range(0) != 0 ? 1.0 : 0.0};
+    auto transport = std::make_unique<ion::MemoryTransport>();
+    auto* memory_transport = transport.get();
+    ion::Http2Connection conn{std::move(transport), "127.0.0.1", router,
+                              ion::DEFAULT_INDEXING_POLICY_CONFIG, sampler};
+    memory_transport->feed(warmup);
+    conn.process();
+    memory_transport->clear_output();
+
+    uint32_t stream_id = 3;
+    const auto allocations_before = allocation_count();
+    for (auto _ : state) {
+        ion::store_uint32_be(stream_id, std::span{request}.subspan<5, 4>());
+        stream_id += 2;
+        memory_transport->feed(request);
+        if (conn.process() != ion::Http2ProcessResult::WantRead) {
+            state.SkipWithError("connection did not consume the request");
+            break;
+        }
+        memory_transport->clear_output();
+    }
+    report(state, allocation_count() - allocations_before, state.iterations());
+}
+BENCHMARK(BM_Http2Connection_SteadyState)->ArgName("sampled")->Arg(1)->Arg(0);
@@ -0,0 +1,224 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "hpack/byte_reader.h"
+#include "hpack/dynamic_table.h"
+#include "hpack/header_block_decoder.h"
+#include "hpack/header_block_encoder.h"
+#include "hpack/huffman_codes.h"
+#include "hpack/huffman_tree.h"
+#include "hpack/int_decoder.h"
+
+// RFC 7541 appendix C.4: three consecutive requests on one connection, Huffman encoded
+static const std::vector<std::vector<uint8_t>> RFC7541_REQUESTS = {
+    {0x82, 0x86, 0x84, 0x41, 0x8c, 0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4,
+     0xff},
+    {0x82, 0x86, 0x84, 0xbe, 0x58, 0x86, 0xa8, 0xeb, 0x10, 0x64, 0x9c, 0xbf},
+    {0x82, 0x87, 0x85, 0xbf, 0x40, 0x88, 0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xa9, 0x7d, 0x7f, 0x89, 0x25,
+     0xa8, 0x49, 0xe9, 0x5b, 0xb8, 0xe8, 0xb4, 0xbf},
+};
+
+// top-level navigation as sent by a current desktop browser
+static const std::vector<ion::HttpHeader> BROWSER_REQUEST = {
+    {":method", "GET"},
+    {":authority", "www.example.com"},
+    {":scheme", "https"},
+    {":path", "/index.html"},
+    {"sec-ch-ua", R"("Chromium";v="130", "Google Chrome";v="130", "Not?A_Brand";v="99")"},
+    {"sec-ch-ua-mobile", "?0"},
+    {"sec-ch-ua-platform", R"("macOS")"},
+    {"upgrade-insecure-requests", "1"},
+    {"user-agent",
+     "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/537.36 (KHTML, like Gecko) "
+     "Chrome/130.0.0.0 Safari/537.36"},
+    {"accept",
+     "text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,image/apng,*/"
+     "*;q=0.8,application/signed-exchange;v=b3;q=0.7"},
+    {"sec-fetch-site", "none"},
+    {"sec-fetch-mode", "navigate"},
+    {"sec-fetch-user", "?1"},
+    {"sec-fetch-dest", "document"},
+    {"accept-encoding", "gzip, deflate, br, zstd"},
+    {"accept-language", "en-GB,en-US;q=0.9,en;q=0.8"},
+    {"priority", "u=0, i"},
+};
+
+static const std::vector<ion::HttpHeader> RESPONSE = {
+    {":status", "200"},
+    {"content-type", "text/html; charset=utf-8"},
+    {"content-length", "5124"},
+    {"cache-control", "public, max-age=3600"},
+    {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+    {"last-modified", "Mon, 21 Oct 2013 20:13:21 GMT"},
+    {"etag", "\"5124-1382386401\""},
+    {"server", "ion"},
+};
+
+static void populate_huffman_tree(ion::HuffmanTree& tree) {
+    for (uint16_t i = 0; i < static_cast<uint16_t>(ion::HUFFMAN_CODES.size()); i++) {
+        const auto code = ion::HUFFMAN_CODES[i];
+        tree.insert_symbol(static_cast<uint8_t>(i), code.lsb_aligned_code, code.code_len);
+    }
+}
+
+static std::vector<uint8_t> huffman_encode(const std::string& str) {
+    std::vector<uint8_t> out{};
+    uint64_t bits = 0;
+    int bit_count = 0;
+    for (const char c : str) {
+        const auto code = ion::HUFFMAN_CODES[static_cast<uint8_t>(c)];
+        bits = (bits << code.code_len) | code.lsb_aligned_code;
+        bit_count += code.code_len;
+        while (bit_count >= 8) {
+            bit_count -= 8;
+            out.push_back(static_cast<uint8_t>(bits >> bit_count));
+        }
+    }
+    if (bit_count > 0) {
+        // pad with the most significant bits of EOS (all ones)
+        out.push_back(static_cast<uint8_t>((bits << (8 - bit_count)) | (0xff >> bit_count)));
+    }
+    return out;
+}
+
+static void BM_HeaderBlockDecoder_Rfc7541Requests(benchmark::State& state) {
+    auto dynamic_table = ion::DynamicTable{};
+    auto decoder = ion::HeaderBlockDecoder{dynamic_table};
+    size_t bytes = 0;
+    for (const auto& block : RFC7541_REQUESTS) {
+        bytes += block.size();
+    }
+
+    for (auto _ : state) {
+        // the requests reference each other's dynamic table entries, so replay from empty
+        dynamic_table.set_max_table_size(0);
+        dynamic_table.set_max_table_size(ion::DEFAULT_MAX_TABLE_SIZE);
+        for (const auto& block : RFC7541_REQUESTS) {
+            auto hdrs = decoder.decode(block);
+            benchmark::DoNotOptimize(hdrs);
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * RFC7541_REQUESTS.size()));
+}
+BENCHMARK(BM_HeaderBlockDecoder_Rfc7541Requests);
+
+static void BM_HeaderBlockDecoder_BrowserRequest(benchmark::State& state) {
+    const bool warm = state.range(0) != 0;
+    auto encoder_table = ion::DynamicTable{};
+    auto encoder = ion::HeaderBlockEncoder{encoder_table};
+    const auto first = encoder.encode(BROWSER_REQUEST);
+    // a repeat request on the same connection is mostly dynamic table references
+    const auto repeat = encoder.encode(BROWSER_REQUEST);
+
+    auto dynamic_table = ion::DynamicTable{};
+    auto decoder = ion::HeaderBlockDecoder{dynamic_table};
+    const auto& block = warm ? repeat : first;
+
+    for (auto _ : state) {
+        dynamic_table.set_max_table_size(0);
+        dynamic_table.set_max_table_size(ion::DEFAULT_MAX_TABLE_SIZE);
+        if (warm) {
+            state.PauseTiming();
+            auto prime = decoder.decode(first);
+            benchmark::DoNotOptimize(prime);
+            state.ResumeTiming();
+        }
+        auto hdrs = decoder.decode(block);
+        benchmark::DoNotOptimize(hdrs);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * block.size()));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HeaderBlockDecoder_BrowserRequest)->ArgName("warm")->Arg(0)->Arg(1);
+
+static void BM_HeaderBlockEncoder_Response(benchmark::State& state) {
+    const bool warm = state.range(0) != 0;
+    auto dynamic_table = ion::DynamicTable{};
+    auto encoder = ion::HeaderBlockEncoder{dynamic_table};
+
+    for (auto _ : state) {
+        if (!warm) {
+            dynamic_table.set_max_table_size(0);
+            dynamic_table.set_max_table_size(ion::DEFAULT_MAX_TABLE_SIZE);
+        }
+        auto bytes = encoder.encode(RESPONSE);
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HeaderBlockEncoder_Response)->ArgName("warm")->Arg(0)->Arg(1);
+
+static void BM_HuffmanTree_Decode(benchmark::State& state) {
+    auto tree = ion::HuffmanTree{};
+    populate_huffman_tree(tree);
+
+    std::vector<std::vector<uint8_t>> corpus{};
+    size_t bytes = 0;
+    for (const auto& hdr : BROWSER_REQUEST) {
+        corpus.push_back(huffman_encode(hdr.value));
+        bytes += corpus.back().size();
+    }
+
+    for (auto _ : state) {
+        for (const auto& encoded : corpus) {
+            auto decoded = tree.decode(encoded);
+            benchmark::DoNotOptimize(decoded);
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+BENCHMARK(BM_HuffmanTree_Decode);
+
+static void BM_IntegerDecoder_Decode(benchmark::State& state) {
+    // RFC 7541 C.1: 10 in a 5-bit prefix, 1337 in a 5-bit prefix, plus a 4-byte value
+    static constexpr auto SMALL = std::to_array<uint8_t>({0x0a});
+    static constexpr auto MEDIUM = std::to_array<uint8_t>({0x1f, 0x9a, 0x0a});
+    static constexpr auto LARGE = std::to_array<uint8_t>({0x1f, 0xe1, 0xff, 0x03});
+
+    for (auto _ : state) {
+        for (const std::span<const uint8_t> data : {std::span<const uint8_t>{SMALL},
+                                                    std::span<const uint8_t>{MEDIUM},
+                                                    std::span<const uint8_t>{LARGE}}) {
+            ByteReader reader{data};
+            auto value = ion::IntegerDecoder::decode(reader, 5);
+            benchmark::DoNotOptimize(value);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 3);
+}
+BENCHMARK(BM_IntegerDecoder_Decode);
+
+static void BM_DynamicTable_Insert(benchmark::State& state) {
+    // small 4 KiB table so steady state includes evictions
+    auto dynamic_table = ion::DynamicTable{4096};
+    size_t i = 0;
+
+    for (auto _ : state) {
+        dynamic_table.insert(BROWSER_REQUEST[i++ % BROWSER_REQUEST.size()]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DynamicTable_Insert);
+
+static void BM_DynamicTable_Find(benchmark::State& state) {
+    const bool hit = state.range(0) != 0;
+    auto dynamic_table = ion::DynamicTable{};
+    for (const auto& hdr : BROWSER_REQUEST) {
+        dynamic_table.insert(hdr);
+    }
+    const auto needle = hit ? BROWSER_REQUEST.front() : ion::HttpHeader{"x-missing", "value"};
+
+    for (auto _ : state) {
+        auto idx = dynamic_table.find(needle);
+        benchmark::DoNotOptimize(idx);
+        auto name_idx = dynamic_table.find_name(needle.name);
+        benchmark::DoNotOptimize(name_idx);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DynamicTable_Find)->ArgName("hit")->Arg(0)->Arg(1);
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include <format>
+#include <string>
+#include <vector>
+
+#include "compiled_route_table.h"
+#include "router.h"
+
+struct StatusHandler {
+    ion::HttpResponse operator()(const ion::HttpRequest&) const {
+        return ion::HttpResponse{.status_code = 200};
+    }
+};
+
+using CompiledRoutes =
+    ion::CompiledRouteTable<ion::CompiledRoute<"GET", "/", StatusHandler>,
+                            ion::CompiledRoute<"GET", "/api/v1/users", StatusHandler>,
+                            ion::CompiledRoute<"POST", "/api/v1/users", StatusHandler>,
+                            ion::CompiledRoute<"GET", "/api/v1/orders", StatusHandler>,
+                            ion::CompiledRoute<"GET", "/api/v1/products", StatusHandler>,
+                            ion::CompiledRoute<"GET", "/health", StatusHandler>,
+                            ion::CompiledRoute<"GET", "/metrics", StatusHandler>,
+                            ion::CompiledRoute<"GET", "/_ion/status", StatusHandler>>;
+
+static void dispatch_loop(benchmark::State& state, const ion::RequestDispatcher& dispatcher) {
+    auto req = ion::HttpRequest{
+        .method = ion::HttpMethod::Get, .path = "/api/v1/products", .method_name = "GET"};
+    for (auto _ : state) {
+        auto resp = dispatcher.dispatch(req);
+        benchmark::DoNotOptimize(resp);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// runtime router with the same eight routes plus `range(0)` unrelated API routes
+static void BM_Dispatch_Router(benchmark::State& state) {
+    auto router = ion::Router{};
+    for (const auto& [method, path] : std::vector<std::pair<std::string, std::string>>{
+             {"GET", "/"},
+             {"GET", "/api/v1/users"},
+             {"POST", "/api/v1/users"},
+             {"GET", "/api/v1/orders"},
+             {"GET", "/api/v1/products"},
+             {"GET", "/health"},
+             {"GET", "/metrics"},
+             {"GET", "/_ion/status"}}) {
+        router.add_route(path, method, StatusHandler{});
+    }
+    for (int64_t i = 0; i < state.range(0); i++) {
+        router.add_route(std::format("/api/v2/resource{}/:id", i), "GET", StatusHandler{});
+    }
+    dispatch_loop(state, router);
+}
+BENCHMARK(BM_Dispatch_Router)->ArgName("extra_routes")->Arg(0)->Arg(500);
+
+static void BM_Dispatch_CompiledRouteTable(benchmark::State& state) {
+    const auto routes = CompiledRoutes{};
+    dispatch_loop(state, routes);
+}
+BENCHMARK(BM_Dispatch_CompiledRouteTable);
@@ -1,44 +1,225 @@
 #include "access_log.h"
 
+#include <fcntl.h>
 #include <spdlog/spdlog.h>
+#include <unistd.h>
 
+#include <atomic>
+#include <cerrno>
+#include <cstring>
 #include <format>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
 
+#include "access_log_binary.h"
+#include "spsc_ring.h"
 #include "system_clock.h"
 
 namespace ion {
 
-void AccessLog::log_request(std::vector<HttpHeader>& req_headers, uint16_t status_code,
-                            size_t content_length, const std::string& client_ip) {
-    auto access_log = spdlog::get(ACCESS_LOGGER_NAME);
-    if (!access_log) {
-        return;
+static constexpr size_t RING_CAPACITY = 4096;
+static constexpr size_t WRITE_BATCH_SIZE = 64 * 1024;
+static constexpr std::chrono::milliseconds WRITER_INTERVAL{10};
+
+using AccessLogRing = SpscRing<AccessLogRecord, RING_CAPACITY>;
+
+class AccessLogWriter {
+   public:
+    AccessLogWriter(int fd, AccessLogFormat format, uint64_t generation)
+        : fd_(fd), generation_(generation) {
+        batch_.reserve(WRITE_BATCH_SIZE + 1024);
+        if (format == AccessLogFormat::Binary) {
+            binary_.emplace().begin_segment(batch_);
+        }
+        thread_ = std::thread([this] { run(); });
     }
 
-    std::string method{"-"};
-    std::string path{"-"};
-    std::string user_agent{"-"};
-    std::string referrer{"-"};
+    ~AccessLogWriter() {
+        stopping_.store(true, std::memory_order_relaxed);
+        thread_.join();
+        drain();
+        ::close(fd_);
+    }
+
+    AccessLogWriter(const AccessLogWriter&) = delete;
+    AccessLogWriter& operator=(const AccessLogWriter&) = delete;
 
-    for (const auto& [name, value] : req_headers) {
-        if (name == ":method") {
-            method = value;
+    [[nodiscard]] uint64_t generation() const {
+        return generation_;
+    }
+
+    AccessLogRing* register_producer() {
+        std::lock_guard lock{rings_mutex_};
+        return rings_.emplace_back(std::make_unique<AccessLogRing>()).get();
+    }
+
+   private:
+    int fd_;
+    uint64_t generation_;
+    std::mutex rings_mutex_{};
+    std::vector<std::unique_ptr<AccessLogRing>> rings_{};
+    std::string batch_{};
+    std::optional<BinaryAccessLogEncoder> binary_{};
+    uint64_t reported_drops_{};
+    std::atomic<bool> stopping_{};
+    std::thread thread_{};
+
+    void run() {
+        while (!stopping_.load(std::memory_order_relaxed)) {
+            if (drain() == 0) {
+                std::this_thread::sleep_for(WRITER_INTERVAL);
+            }
         }
-        if (name == ":path") {
-            path = value;
+    }
+
+    size_t drain() {
+        size_t count = 0;
+        {
+            std::lock_guard lock{rings_mutex_};
+            for (const auto& ring : rings_) {
+                while (const auto* record = ring->front()) {
+                    append(*record);
+                    ring->pop();
+                    count++;
+                    if (pending_bytes() >= WRITE_BATCH_SIZE) {
+                        write_batch();
+                    }
+                }
+            }
         }
+        write_batch();
+
+        if (const auto drops = AccessLog::dropped(); drops != reported_drops_) {
+            spdlog::warn("access log falling behind, {} records dropped", drops - reported_drops_);
+            reported_drops_ = drops;
+        }
+        return count;
+    }
+
+    void append(const AccessLogRecord& record) {
+        if (binary_) {
+            binary_->append(record, batch_);
+        } else {
+            AccessLog::format_clf(record, batch_);
+        }
+    }
+
+    [[nodiscard]] size_t pending_bytes() const {
+        return batch_.size() + (binary_ ? binary_->pending_bytes() : 0);
+    }
+
+    void write_batch() {
+        if (binary_) {
+            binary_->finish_chunk(batch_);
+        }
+        std::string_view pending{batch_};
+        while (!pending.empty()) {
+            const auto written = ::write(fd_, pending.data(), pending.size());
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                spdlog::error("failed to write access log: {}", strerror(errno));
+                batch_.clear();
+                if (binary_) {
+                    // the lost chunk may have interned strings later records refer to, and may
+                    // be torn, so start over with a segment readers can resync on
+                    binary_->begin_segment(batch_);
+                }
+                return;
+            }
+            pending.remove_prefix(static_cast<size_t>(written));
+        }
+        batch_.clear();
+    }
+};
+
+static std::unique_ptr<AccessLogWriter> writer{};
+static std::atomic<AccessLogWriter*> active_writer{};
+static std::atomic<uint64_t> dropped_records{};
+static uint64_t writer_generation{};
+
+struct ProducerRing {
+    AccessLogRing* ring{};
+    uint64_t generation{};
+};
+
+void AccessLog::open(const std::string& path, AccessLogFormat format) {
+    close();
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error(std::format("failed to open access log {}: {}", path,
+                                             strerror(errno)));
+    }
+    writer = std::make_unique<AccessLogWriter>(fd, format, ++writer_generation);
+    active_writer.store(writer.get(), std::memory_order_release);
+}
+
+void AccessLog::close() {
+    active_writer.store(nullptr, std::memory_order_release);
+    writer.reset();
+}
+
+bool AccessLog::is_open() {
+    return active_writer.load(std::memory_order_acquire) != nullptr;
+}
+
+uint64_t AccessLog::dropped() {
+    return dropped_records.load(std::memory_order_relaxed);
+}
+
+void AccessLog::log_request(const HttpRequest& req, uint16_t status_code, size_t content_length,
+                            const std::string& client_ip) {
+    auto* const current_writer = active_writer.load(std::memory_order_acquire);
+    if (!current_writer) {
+        return;
+    }
+
+    thread_local ProducerRing producer{};
+    if (producer.generation != current_writer->generation()) {
+        producer = {current_writer->register_producer(), current_writer->generation()};
+    }
+
+    auto* record = producer.ring->try_claim();
+    if (!record) {
+        dropped_records.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    record->time = std::chrono::system_clock::now();
+    record->content_length = content_length;
+    record->status_code = status_code;
+    record->method.assign(req.method_string());
+    record->client_ip.assign(client_ip);
+    record->path.assign(req.path);
+    record->referrer.clear();
+    record->user_agent.clear();
+    for (const auto& [name, value] : req.headers) {
         if (name == "user-agent") {
-            user_agent = value;
+            record->user_agent.assign(value);
         }
         if (name == "referer") {
-            referrer = value;
+            record->referrer.assign(value);
         }
     }
-    const auto entry =
-        std::format(R"({} - - {} "{} {} HTTP/2" {} {} "{}" "{}")",
-                    (client_ip.empty() ? "-" : client_ip), SystemClock::clf_timestamp(), method,
-                    path, status_code, content_length, referrer, user_agent);
-    access_log->info(entry);
+    producer.ring->commit();
+}
+
+static std::string_view or_dash(std::string_view value) {
+    return value.empty() ? std::string_view{"-"} : value;
+}
+
+void AccessLog::format_clf(const AccessLogRecord& record, std::string& out) {
+    std::format_to(std::back_inserter(out), R"({} - - {} "{} {} HTTP/2" {} {} "{}" "{}")"
+                   "\n",
+                   or_dash(record.client_ip.view()), SystemClock::clf_timestamp(record.time),
+                   or_dash(record.method.view()), or_dash(record.path.view()), record.status_code,
+                   record.content_length, or_dash(record.referrer.view()),
+                   or_dash(record.user_agent.view()));
 }
 
 }  // namespace ion
@@ -1,17 +1,86 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstdint>
-#include <vector>
+#include <cstring>
+#include <string>
+#include <string_view>
 
-#include "hpack/http_header.h"
+#include "http_response.h"
 
 namespace ion {
 
+// fixed capacity string stored inline so records can be queued without allocating. Longer
+// values are cut short and end in TRUNCATION_MARKER, so a log reader can tell
+inline constexpr std::string_view TRUNCATION_MARKER{"..."};
+
+template <size_t N>
+struct InlineString {
+    static_assert(N > TRUNCATION_MARKER.size());
+
+    std::array<char, N> data;
+    uint16_t size;
+    // not kept by the binary format, where the marker alone shows it
+    bool truncated;
+
+    void assign(std::string_view value) {
+        truncated = value.size() > N;
+        if (!truncated) {
+            size = static_cast<uint16_t>(value.size());
+            std::memcpy(data.data(), value.data(), size);
+            return;
+        }
+        const size_t kept = N - TRUNCATION_MARKER.size();
+        std::memcpy(data.data(), value.data(), kept);
+        std::memcpy(data.data() + kept, TRUNCATION_MARKER.data(), TRUNCATION_MARKER.size());
+        size = static_cast<uint16_t>(N);
+    }
+
+    void clear() {
+        size = 0;
+        truncated = false;
+    }
+
+    [[nodiscard]] std::string_view view() const {
+        return {data.data(), size};
+    }
+};
+
+struct AccessLogRecord {
+    std::chrono::system_clock::time_point time;
+    uint64_t content_length;
+    uint16_t status_code;
+    InlineString<16> method;
+    InlineString<46> client_ip;
+    InlineString<256> path;
+    InlineString<128> referrer;
+    InlineString<192> user_agent;
+};
+
+enum class AccessLogFormat {
+    // Combined Log Format text lines
+    Clf,
+    // compact chunked records, see access_log_binary.h; read back with ion-logcat
+    Binary,
+};
+
+// Requests are captured into a lock-free ring owned by the calling thread (one per event loop)
+// and formatted and written in batches by a background thread. If a ring fills up, records are
+// dropped and counted rather than blocking the caller.
 class AccessLog {
    public:
-    static constexpr std::string ACCESS_LOGGER_NAME = "access";
+    // starts the writer, appending to path; throws std::runtime_error if it can't be opened
+    static void open(const std::string& path, AccessLogFormat format = AccessLogFormat::Clf);
+    // writes out everything queued and stops the writer. Must not race log_request()
+    static void close();
+    [[nodiscard]] static bool is_open();
+    [[nodiscard]] static uint64_t dropped();
 
-    static void log_request(std::vector<HttpHeader>& req_headers, uint16_t status_code,
-                            size_t content_length, const std::string& client_ip);
+    static void log_request(const HttpRequest& req, uint16_t status_code, size_t content_length,
+                            const std::string& client_ip);
+    // appends the record as a Combined Log Format line
+    static void format_clf(const AccessLogRecord& record, std::string& out);
 };
 
 }  // namespace ion
@@ -0,0 +1,322 @@
+#include "access_log_binary.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <optional>
+
+namespace ion {
+
+static constexpr uint8_t CHUNK_SEGMENT = 0x01;
+static constexpr uint8_t CHUNK_RECORDS = 0x02;
+static constexpr std::string_view SEGMENT_MAGIC{"ionlog"};
+static constexpr uint8_t FORMAT_VERSION = 1;
+// a SEGMENT chunk up to its version byte, searched for to resync after damaged data
+static constexpr std::array<uint8_t, 2 + SEGMENT_MAGIC.size()> SEGMENT_MARKER{
+    CHUNK_SEGMENT, SEGMENT_MAGIC.size() + 1, 'i', 'o', 'n', 'l', 'o', 'g'};
+
+static constexpr uint64_t STRING_INTERNED = 0;
+static constexpr uint64_t STRING_LITERAL = 1;
+static constexpr uint64_t STRING_ID_BASE = 2;
+
+static constexpr size_t MAX_VARINT_BYTES = 10;
+// furthest from the epoch a decoded timestamp may be, so it fits a system_clock time_point
+static constexpr int64_t MAX_TIME_MS = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                           std::chrono::system_clock::duration::max())
+                                           .count();
+
+static void write_varint(uint64_t value, std::string& out) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+static uint64_t zigzag_encode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t zigzag_decode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+static void write_chunk(uint8_t type, std::string_view payload, std::string& out) {
+    out.push_back(static_cast<char>(type));
+    write_varint(payload.size(), out);
+    out.append(payload);
+}
+
+void BinaryAccessLogEncoder::begin_segment(std::string& out) {
+    finish_chunk(out);
+    strings_.clear();
+    last_time_ms_ = 0;
+
+    std::string payload{SEGMENT_MAGIC};
+    payload.push_back(static_cast<char>(FORMAT_VERSION));
+    write_chunk(CHUNK_SEGMENT, payload, out);
+}
+
+void BinaryAccessLogEncoder::append(const AccessLogRecord& record, std::string& out) {
+    if (strings_.size() >= MAX_INTERNED_STRINGS) {
+        // otherwise strings first seen after the table filled up would be written in full for
+        // as long as the log stays open
+        begin_segment(out);
+    }
+    const int64_t time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                record.time.time_since_epoch())
+                                .count();
+    write_varint(zigzag_encode(time_ms - last_time_ms_), chunk_);
+    last_time_ms_ = time_ms;
+
+    write_varint(record.status_code, chunk_);
+    write_varint(record.content_length, chunk_);
+    write_string(record.method.view());
+    write_string(record.client_ip.view());
+    write_string(record.path.view());
+    write_string(record.referrer.view());
+    write_string(record.user_agent.view());
+}
+
+void BinaryAccessLogEncoder::finish_chunk(std::string& out) {
+    if (chunk_.empty()) {
+        return;
+    }
+    write_chunk(CHUNK_RECORDS, chunk_, out);
+    chunk_.clear();
+}
+
+size_t BinaryAccessLogEncoder::pending_bytes() const {
+    return chunk_.size();
+}
+
+void BinaryAccessLogEncoder::write_string(std::string_view value) {
+    if (const auto it = strings_.find(value); it != strings_.end()) {
+        write_varint(it->second + STRING_ID_BASE, chunk_);
+        return;
+    }
+
+    if (strings_.size() < MAX_INTERNED_STRINGS) {
+        strings_.emplace(value, static_cast<uint32_t>(strings_.size()));
+        write_varint(STRING_INTERNED, chunk_);
+    } else {
+        write_varint(STRING_LITERAL, chunk_);
+    }
+    write_varint(value.size(), chunk_);
+    chunk_.append(value);
+}
+
+namespace {
+
+class Cursor {
+   public:
+    explicit Cursor(std::span<const uint8_t> data) : data_(data) {}
+
+    [[nodiscard]] bool empty() const {
+        return data_.empty();
+    }
+
+    [[nodiscard]] size_t remaining() const {
+        return data_.size();
+    }
+
+    std::optional<uint64_t> varint() {
+        uint64_t value = 0;
+        for (size_t i = 0; i < data_.size() && i < MAX_VARINT_BYTES; i++) {
+            value |= static_cast<uint64_t>(data_[i] & 0x7f) << (7 * i);
+            if ((data_[i] & 0x80) == 0) {
+                data_ = data_.subspan(i + 1);
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<std::span<const uint8_t>> bytes(size_t count) {
+        if (count > data_.size()) {
+            return std::nullopt;
+        }
+        const auto result = data_.first(count);
+        data_ = data_.subspan(count);
+        return result;
+    }
+
+   private:
+    std::span<const uint8_t> data_;
+};
+
+}  // namespace
+
+// offset of the first SEGMENT chunk in data, if any
+static std::optional<size_t> find_segment(std::span<const uint8_t> data) {
+    const auto found = std::ranges::search(data, SEGMENT_MARKER);
+    if (found.empty()) {
+        return std::nullopt;
+    }
+    return static_cast<size_t>(found.begin() - data.begin());
+}
+
+std::expected<size_t, BinaryAccessLogError> BinaryAccessLogDecoder::decode(
+    std::span<const uint8_t> data, const RecordCallback& on_record, bool at_end) {
+    size_t consumed = 0;
+    while (consumed < data.size()) {
+        const auto rest = data.subspan(consumed);
+        if (resyncing_) {
+            const auto next = find_segment(rest);
+            if (!next) {
+                size_t skip = rest.size();
+                if (!at_end) {
+                    // keep what could be the start of a marker split across calls
+                    skip -= std::min(skip, SEGMENT_MARKER.size() - 1);
+                }
+                skipped_bytes_ += skip;
+                consumed += skip;
+                break;
+            }
+            skipped_bytes_ += *next;
+            consumed += *next;
+            resyncing_ = false;
+            in_segment_ = false;
+            continue;
+        }
+
+        const auto chunk = decode_chunk(rest, on_record);
+        if (!chunk && !seen_segment_) {
+            return std::unexpected(chunk.error());
+        }
+        if (chunk && *chunk != 0) {
+            consumed += *chunk;
+            continue;
+        }
+        // a chunk still incomplete at the end is only damaged if a segment follows it;
+        // otherwise the file is just truncated there
+        if (chunk && (!at_end || !find_segment(rest.subspan(1)))) {
+            break;
+        }
+        resyncing_ = true;
+        skipped_bytes_++;
+        consumed++;
+    }
+    return consumed;
+}
+
+uint64_t BinaryAccessLogDecoder::skipped_bytes() const {
+    return skipped_bytes_;
+}
+
+std::expected<size_t, BinaryAccessLogError> BinaryAccessLogDecoder::decode_chunk(
+    std::span<const uint8_t> data, const RecordCallback& on_record) {
+    Cursor cursor{data};
+    const auto type = (*cursor.bytes(1))[0];
+    // checked before waiting for the whole chunk so other files are rejected early
+    if (type != CHUNK_SEGMENT && type != CHUNK_RECORDS) {
+        return std::unexpected(BinaryAccessLogError::UnknownChunk);
+    }
+    if (type == CHUNK_RECORDS && !in_segment_) {
+        return std::unexpected(BinaryAccessLogError::MissingSegment);
+    }
+
+    const auto length = cursor.varint();
+    if (!length) {
+        if (cursor.remaining() >= MAX_VARINT_BYTES) {
+            return std::unexpected(BinaryAccessLogError::Malformed);
+        }
+        return 0;
+    }
+    const auto payload = cursor.bytes(*length);
+    if (!payload) {
+        return 0;
+    }
+
+    if (type == CHUNK_SEGMENT) {
+        if (payload->size() != SEGMENT_MAGIC.size() + 1 ||
+            !std::ranges::equal(payload->first(SEGMENT_MAGIC.size()), SEGMENT_MAGIC)) {
+            return std::unexpected(BinaryAccessLogError::Malformed);
+        }
+        if (payload->back() != FORMAT_VERSION) {
+            return std::unexpected(BinaryAccessLogError::UnsupportedVersion);
+        }
+        strings_.clear();
+        last_time_ms_ = 0;
+        in_segment_ = true;
+        seen_segment_ = true;
+    } else {
+        // records are only passed on once the whole chunk has decoded, so a torn chunk that
+        // swallowed the data after it yields nothing
+        chunk_records_.clear();
+        if (auto result = decode_records(*payload); !result) {
+            return std::unexpected(result.error());
+        }
+        for (const auto& record : chunk_records_) {
+            on_record(record);
+        }
+    }
+    return data.size() - cursor.remaining();
+}
+
+std::expected<void, BinaryAccessLogError> BinaryAccessLogDecoder::decode_records(
+    std::span<const uint8_t> payload) {
+    Cursor cursor{payload};
+    AccessLogRecord record{};
+
+    const auto read_string = [&](auto& field) -> bool {
+        const auto reference = cursor.varint();
+        if (!reference) {
+            return false;
+        }
+        if (*reference >= STRING_ID_BASE) {
+            const auto id = *reference - STRING_ID_BASE;
+            if (id >= strings_.size()) {
+                return false;
+            }
+            field.assign(strings_[id]);
+            return true;
+        }
+
+        const auto length = cursor.varint();
+        if (!length) {
+            return false;
+        }
+        const auto bytes = cursor.bytes(*length);
+        if (!bytes) {
+            return false;
+        }
+        const std::string_view value{reinterpret_cast<const char*>(bytes->data()), bytes->size()};
+        if (*reference == STRING_INTERNED) {
+            strings_.emplace_back(value);
+        }
+        field.assign(value);
+        return true;
+    };
+
+    while (!cursor.empty()) {
+        const auto time_delta = cursor.varint();
+        const auto status_code = cursor.varint();
+        const auto content_length = cursor.varint();
+        if (!time_delta || !status_code || !content_length) {
+            return std::unexpected(BinaryAccessLogError::Malformed);
+        }
+        if (!read_string(record.method) || !read_string(record.client_ip) ||
+            !read_string(record.path) || !read_string(record.referrer) ||
+            !read_string(record.user_agent)) {
+            return std::unexpected(BinaryAccessLogError::Malformed);
+        }
+
+        // last_time_ms_ is always within MAX_TIME_MS, so these bounds can't overflow; a delta
+        // outside them can only come from damaged data
+        const int64_t delta = zigzag_decode(*time_delta);
+        if (delta > MAX_TIME_MS - last_time_ms_ || delta < -MAX_TIME_MS - last_time_ms_) {
+            return std::unexpected(BinaryAccessLogError::Malformed);
+        }
+        last_time_ms_ += delta;
+        record.time = std::chrono::system_clock::time_point{
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::milliseconds{last_time_ms_})};
+        record.status_code = static_cast<uint16_t>(*status_code);
+        record.content_length = *content_length;
+        chunk_records_.push_back(record);
+    }
+    return {};
+}
+
+}  // namespace ion
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "access_log.h"
+
+namespace ion {
+
+// Binary access log layout. A file is a sequence of chunks, each a type byte, a varint payload
+// length and the payload:
+//  - SEGMENT: "ionlog" and a version byte. Starts a new string table; one is written every
+//    time the log is opened so appending to an existing file is fine.
+//  - RECORDS: records back to back, each a series of varints: time in milliseconds since the
+//    epoch (zigzag encoded delta from the previous record in the segment), status code,
+//    content length, then string references for method, client ip, path, referrer and user
+//    agent.
+// A string reference is 0 followed by a length-prefixed string that takes the next id in the
+// segment's string table, 1 followed by a length-prefixed string that isn't interned (once the
+// table is full; the encoder starts a new segment before the next record), or an interned
+// string's id + 2. Chunks are only ever written whole, so a truncated file loses at most its
+// last chunk. A chunk torn by a failed write is followed by a new segment, which readers skip
+// ahead to.
+class BinaryAccessLogEncoder {
+   public:
+    static constexpr size_t MAX_INTERNED_STRINGS = 16 * 1024;
+
+    // appends a SEGMENT chunk and forgets all interned strings
+    void begin_segment(std::string& out);
+    // encodes a record into the pending RECORDS chunk, first starting a new segment in out if
+    // the string table is full so it refills from current traffic
+    void append(const AccessLogRecord& record, std::string& out);
+    // appends the pending records, if any, as a RECORDS chunk
+    void finish_chunk(std::string& out);
+    [[nodiscard]] size_t pending_bytes() const;
+
+   private:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view value) const {
+            return std::hash<std::string_view>{}(value);
+        }
+    };
+
+    std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> strings_{};
+    std::string chunk_{};
+    int64_t last_time_ms_{};
+
+    void write_string(std::string_view value);
+};
+
+enum class BinaryAccessLogError { MissingSegment, UnsupportedVersion, UnknownChunk, Malformed };
+
+class BinaryAccessLogDecoder {
+   public:
+    using RecordCallback = std::function<void(const AccessLogRecord&)>;
+
+    // decodes every complete chunk at the start of data and returns how many bytes were
+    // consumed; a trailing partial chunk is left for the next call, unless at_end says no more
+    // data will follow. Once a valid segment has been read, damaged data is skipped up to the
+    // next SEGMENT chunk instead of failing the decode
+    std::expected<size_t, BinaryAccessLogError> decode(std::span<const uint8_t> data,
+                                                       const RecordCallback& on_record,
+                                                       bool at_end = false);
+    // bytes of damaged data skipped so far
+    [[nodiscard]] uint64_t skipped_bytes() const;
+
+   private:
+    std::vector<std::string> strings_{};
+    int64_t last_time_ms_{};
+    bool in_segment_{};
+    bool seen_segment_{};
+    // looking for the next SEGMENT chunk after damaged data
+    bool resyncing_{};
+    uint64_t skipped_bytes_{};
+    std::vector<AccessLogRecord> chunk_records_{};
+
+    // returns the size of the chunk at the start of data, or 0 if it's incomplete
+    std::expected<size_t, BinaryAccessLogError> decode_chunk(std::span<const uint8_t> data,
+                                                             const RecordCallback& on_record);
+    std::expected<void, BinaryAccessLogError> decode_records(std::span<const uint8_t> payload);
+};
+
+}  // namespace ion
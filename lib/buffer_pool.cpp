@@ -0,0 +1,50 @@
+#include "buffer_pool.h"
+
+namespace ion {
+
+static constexpr size_t CONNECTION_BUFFER_CAPACITY = 16 * 1024;
+static constexpr size_t MAX_POOLED_CONNECTION_BUFFERS = 256;
+
+BufferPool::BufferPool(size_t buffer_capacity, size_t max_pooled)
+    : buffer_capacity_(buffer_capacity), max_pooled_(max_pooled) {
+    free_.reserve(max_pooled_);
+}
+
+std::vector<uint8_t> BufferPool::acquire() {
+    if (free_.empty()) {
+        std::vector<uint8_t> buffer{};
+        buffer.reserve(buffer_capacity_);
+        return buffer;
+    }
+    auto buffer = std::move(free_.back());
+    free_.pop_back();
+    return buffer;
+}
+
+void BufferPool::release(std::vector<uint8_t>& buffer) {
+    if (buffer.capacity() == 0) {
+        return;
+    }
+    if (free_.size() < max_pooled_ && buffer.capacity() <= max_buffer_capacity()) {
+        buffer.clear();
+        free_.push_back(std::move(buffer));
+    }
+    // leave the caller with no storage either way
+    std::vector<uint8_t>{}.swap(buffer);
+}
+
+size_t BufferPool::pooled() const {
+    return free_.size();
+}
+
+size_t BufferPool::max_buffer_capacity() const {
+    // a buffer that grew for one large response shouldn't be pinned in the pool
+    return buffer_capacity_ * 4;
+}
+
+BufferPool& BufferPool::local() {
+    thread_local BufferPool pool{CONNECTION_BUFFER_CAPACITY, MAX_POOLED_CONNECTION_BUFFERS};
+    return pool;
+}
+
+}  // namespace ion
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace ion {
+
+// Free list of byte buffers, so connections only hold read/write buffers while they have data
+// in flight and idle connections cost almost nothing. Buffers keep their capacity while pooled.
+class BufferPool {
+   public:
+    BufferPool(size_t buffer_capacity, size_t max_pooled);
+
+    // an empty buffer with at least buffer_capacity reserved
+    std::vector<uint8_t> acquire();
+    // takes the buffer's storage back; buffers that grew past max_buffer_capacity() are freed
+    void release(std::vector<uint8_t>& buffer);
+
+    [[nodiscard]] size_t pooled() const;
+    [[nodiscard]] size_t max_buffer_capacity() const;
+
+    // shared by the connections of the calling thread's event loop
+    static BufferPool& local();
+
+   private:
+    size_t buffer_capacity_;
+    size_t max_pooled_;
+    std::vector<std::vector<uint8_t>> free_{};
+};
+
+}  // namespace ion
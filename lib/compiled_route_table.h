@@ -0,0 +1,166 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "request_dispatcher.h"
+
+namespace ion {
+
+template <size_t N>
+struct FixedString {
+    char data[N]{};
+
+    // NOLINTNEXTLINE(google-explicit-constructor): lets string literals be template arguments
+    consteval FixedString(const char (&str)[N]) {
+        std::copy_n(str, N, data);
+    }
+
+    [[nodiscard]] constexpr std::string_view view() const {
+        return {data, N - 1};
+    }
+};
+
+// Exact method and path (no parameters), dispatched to a default-constructible functor with
+// signature HttpResponse(const HttpRequest&).
+template <FixedString Method, FixedString Path, typename Handler>
+struct CompiledRoute {
+    static constexpr std::string_view method = Method.view();
+    static constexpr HttpMethod method_type = HttpMethodHelper::from_string(method);
+    static constexpr std::string_view path = Path.view();
+    using handler_type = Handler;
+};
+
+namespace detail {
+
+constexpr uint64_t route_hash(std::string_view method, std::string_view path, uint64_t seed) {
+    // FNV-1a with the seed folded into the offset basis
+    uint64_t hash = 0xcbf29ce484222325ULL ^ (seed * 0x9e3779b97f4a7c15ULL);
+    const auto mix = [&hash](char c) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ULL;
+    };
+    std::ranges::for_each(method, mix);
+    mix(' ');
+    std::ranges::for_each(path, mix);
+    return hash;
+}
+
+struct PerfectHash {
+    uint64_t seed;
+    uint64_t mask;
+};
+
+template <typename... Routes>
+consteval bool routes_are_unique() {
+    constexpr std::array<std::pair<std::string_view, std::string_view>, sizeof...(Routes)> keys{
+        {{Routes::method, Routes::path}...}};
+    for (size_t i = 0; i < keys.size(); i++) {
+        for (size_t j = i + 1; j < keys.size(); j++) {
+            if (keys[i] == keys[j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// not constexpr, so reaching it fails compilation with its name in the diagnostic
+inline void no_perfect_hash_for_these_routes() {}
+
+// tables are never grown past this many slots per route
+inline constexpr uint64_t MAX_SLOTS_PER_ROUTE = 64;
+
+// smallest power-of-two table (and a seed for it) in which every route lands in its own slot
+template <typename... Routes>
+consteval PerfectHash find_perfect_hash() {
+    constexpr std::array<std::pair<std::string_view, std::string_view>, sizeof...(Routes)> keys{
+        {{Routes::method, Routes::path}...}};
+    const uint64_t min_size = std::bit_ceil(std::max<size_t>(keys.size(), 1));
+    for (uint64_t size = min_size; size <= min_size * MAX_SLOTS_PER_ROUTE; size *= 2) {
+        for (uint64_t seed = 0; seed < 64; seed++) {
+            bool collision = false;
+            for (size_t i = 0; i < keys.size() && !collision; i++) {
+                for (size_t j = i + 1; j < keys.size() && !collision; j++) {
+                    collision = (route_hash(keys[i].first, keys[i].second, seed) & (size - 1)) ==
+                                (route_hash(keys[j].first, keys[j].second, seed) & (size - 1));
+                }
+            }
+            if (!collision) {
+                return {seed, size - 1};
+            }
+        }
+    }
+    no_perfect_hash_for_these_routes();
+    return {};
+}
+
+}  // namespace detail
+
+// Route table resolved at compile time. The request's method and path are hashed with a perfect
+// hash found during compilation, and the slot selects the route through a fold that the compiler
+// lowers to a switch, so handlers are called directly and can be inlined. Requests that match no
+// route go to the fallback dispatcher (e.g. a Router serving static files) or get a 404.
+//
+// Handlers in the table are called as they are: Router middleware only runs for requests passed
+// on to a Router fallback, so wrap a handler yourself if it needs the same treatment.
+template <typename... Routes>
+class CompiledRouteTable : public RequestDispatcher {
+    static_assert(detail::routes_are_unique<Routes...>(),
+                  "CompiledRouteTable: two routes have the same method and path");
+
+   public:
+    CompiledRouteTable() = default;
+    explicit CompiledRouteTable(typename Routes::handler_type... handlers)
+        : handlers_(std::move(handlers)...) {}
+
+    void set_fallback(const RequestDispatcher& fallback) {
+        fallback_ = &fallback;
+    }
+
+    HttpResponse dispatch(HttpRequest& req) const override {
+        const auto path = std::string_view{req.path}.substr(0, req.path.find('?'));
+        const auto slot = detail::route_hash(req.method_string(), path, HASH.seed) & HASH.mask;
+
+        std::optional<HttpResponse> resp{};
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (void)((SLOTS[I] == slot && try_route<I>(req, path, resp)) || ...);
+        }(std::index_sequence_for<Routes...>{});
+
+        if (resp) {
+            return std::move(*resp);
+        }
+        if (fallback_) {
+            return fallback_->dispatch(req);
+        }
+        return HttpResponse{404};
+    }
+
+   private:
+    static constexpr detail::PerfectHash HASH = detail::find_perfect_hash<Routes...>();
+    static constexpr std::array<uint64_t, sizeof...(Routes)> SLOTS{
+        (detail::route_hash(Routes::method, Routes::path, HASH.seed) & HASH.mask)...};
+
+    std::tuple<typename Routes::handler_type...> handlers_{};
+    const RequestDispatcher* fallback_{};
+
+    template <size_t I>
+    bool try_route(HttpRequest& req, std::string_view path,
+                   std::optional<HttpResponse>& resp) const {
+        using Route = std::tuple_element_t<I, std::tuple<Routes...>>;
+        if (Route::method_type != req.method || Route::path != path ||
+            (Route::method_type == HttpMethod::Other && Route::method != req.method_name)) {
+            return false;
+        }
+        req.route = Route::path;
+        resp.emplace(std::get<I>(handlers_)(req));
+        return true;
+    }
+};
+
+}  // namespace ion
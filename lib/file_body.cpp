@@ -0,0 +1,50 @@
+#include "file_body.h"
+
+#include <fcntl.h>
+#include <spdlog/spdlog.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+namespace ion {
+
+FileBody::FileBody(int fd, size_t offset, size_t length)
+    : fd_(fd), offset_(offset), length_(length) {}
+
+FileBody::~FileBody() {
+    if (fd_ >= 0) {
+        SPDLOG_TRACE("closing file body fd {}", fd_);
+        ::close(fd_);
+    }
+}
+
+std::shared_ptr<const FileBody> FileBody::open(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        spdlog::warn("failed to open file: {}: {}", path, strerror(errno));
+        return nullptr;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        spdlog::warn("not a regular file: {}", path);
+        ::close(fd);
+        return nullptr;
+    }
+    return std::make_shared<const FileBody>(fd, 0, static_cast<size_t>(st.st_size));
+}
+
+int FileBody::fd() const {
+    return fd_;
+}
+
+size_t FileBody::offset() const {
+    return offset_;
+}
+
+size_t FileBody::length() const {
+    return length_;
+}
+
+}  // namespace ion
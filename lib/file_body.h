@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace ion {
+
+// Response body streamed from an open file as it is sent, so large files are never held in
+// memory. Transports that support it pass the bytes straight from the page cache (sendfile).
+class FileBody {
+   public:
+    FileBody(int fd, size_t offset, size_t length);
+    ~FileBody();
+
+    FileBody(const FileBody&) = delete;
+    FileBody& operator=(const FileBody&) = delete;
+    FileBody(FileBody&&) = delete;
+    FileBody& operator=(FileBody&&) = delete;
+
+    // opens the whole of a regular file; nullptr if it can't be opened
+    static std::shared_ptr<const FileBody> open(const std::string& path);
+
+    [[nodiscard]] int fd() const;
+    [[nodiscard]] size_t offset() const;
+    [[nodiscard]] size_t length() const;
+
+   private:
+    int fd_;
+    size_t offset_;
+    size_t length_;
+};
+
+}  // namespace ion
@@ -31,7 +31,7 @@ std::optional<std::vector<uint8_t>> FileReader::read_file(const std::string& pat
         return std::nullopt;
     }
 
-    spdlog::debug("Read file: {} ({} bytes)", path, buffer.size());
+    SPDLOG_DEBUG("Read file: {} ({} bytes)", path, buffer.size());
     return buffer;
 }
 
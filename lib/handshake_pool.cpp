@@ -0,0 +1,93 @@
+#include "handshake_pool.h"
+
+#include <fcntl.h>
+#include <spdlog/spdlog.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace ion {
+
+HandshakePool::HandshakePool(size_t threads) {
+    std::array<int, 2> fds{};
+    if (pipe(fds.data()) != 0) {
+        throw std::runtime_error(std::string{"failed to create handshake pool pipe: "} +
+                                 strerror(errno));
+    }
+    for (const int fd : fds) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    wake_read_fd_ = fds[0];
+    wake_write_fd_ = fds[1];
+
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; i++) {
+        workers_.emplace_back([this] { run(); });
+    }
+    spdlog::info("TLS handshakes offloaded to {} worker threads", threads);
+}
+
+HandshakePool::~HandshakePool() {
+    {
+        std::lock_guard lock{mutex_};
+        stopping_ = true;
+    }
+    jobs_available_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    close(wake_read_fd_);
+    close(wake_write_fd_);
+}
+
+void HandshakePool::submit(int fd, const Transport& transport) {
+    {
+        std::lock_guard lock{mutex_};
+        jobs_.push_back({fd, &transport});
+    }
+    jobs_available_.notify_one();
+}
+
+std::vector<HandshakeResult> HandshakePool::drain() {
+    std::array<uint8_t, 256> buffer;  // NOLINT(*-pro-type-member-init)
+    while (read(wake_read_fd_, buffer.data(), buffer.size()) > 0) {
+    }
+
+    std::vector<HandshakeResult> results{};
+    std::lock_guard lock{mutex_};
+    results.swap(results_);
+    return results;
+}
+
+int HandshakePool::wake_fd() const {
+    return wake_read_fd_;
+}
+
+void HandshakePool::run() {
+    while (true) {
+        Job job{};
+        {
+            std::unique_lock lock{mutex_};
+            jobs_available_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            job = jobs_.front();
+            jobs_.pop_front();
+        }
+
+        auto result = job.transport->handshake();
+        {
+            std::lock_guard lock{mutex_};
+            results_.push_back({job.fd, result});
+        }
+        // a full pipe already guarantees a wake up, so a failed write can be ignored
+        constexpr uint8_t wake_byte = 1;
+        [[maybe_unused]] const auto written = write(wake_write_fd_, &wake_byte, 1);
+    }
+}
+
+}  // namespace ion
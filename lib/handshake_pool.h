@@ -0,0 +1,53 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <expected>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "transports/transport.h"
+
+namespace ion {
+
+struct HandshakeResult {
+    int fd;
+    std::expected<void, TransportError> result;
+};
+
+// Runs transport handshakes (the asymmetric crypto of a TLS accept) on worker threads so a burst
+// of new clients doesn't stall the event loop. A submitted transport must not be used or
+// destroyed by the caller until its result has been collected with drain().
+class HandshakePool {
+   public:
+    explicit HandshakePool(size_t threads);
+    ~HandshakePool();
+
+    HandshakePool(const HandshakePool&) = delete;
+    HandshakePool& operator=(const HandshakePool&) = delete;
+
+    void submit(int fd, const Transport& transport);
+    // results completed since the last call
+    std::vector<HandshakeResult> drain();
+    // becomes readable when results are waiting to be drained
+    [[nodiscard]] int wake_fd() const;
+
+   private:
+    struct Job {
+        int fd;
+        const Transport* transport;
+    };
+
+    std::mutex mutex_{};
+    std::condition_variable jobs_available_{};
+    std::deque<Job> jobs_{};
+    std::vector<HandshakeResult> results_{};
+    bool stopping_{};
+    int wake_read_fd_{-1};
+    int wake_write_fd_{-1};
+    std::vector<std::thread> workers_{};
+
+    void run();
+};
+
+}  // namespace ion
@@ -19,8 +19,8 @@ HttpHeader DynamicTable::get(size_t index) {
 void DynamicTable::insert(const HttpHeader& header) {
     const size_t entry_size = get_header_entry_size(header);
     if (entry_size > max_table_size_) {
-        spdlog::debug("dynamic table: entry too big (sz: {}, max: {}), table wiped", entry_size,
-                      max_table_size_);
+        SPDLOG_DEBUG("dynamic table: entry too big (sz: {}, max: {}), table wiped", entry_size,
+                     max_table_size_);
         table_.clear();
         table_size_ = 0;
         return;
@@ -33,7 +33,7 @@ void DynamicTable::insert(const HttpHeader& header) {
 
     table_.push_front(header);
     table_size_ += entry_size;
-    spdlog::debug("dynamic table: current sz: {}, max: {}", entry_size, max_table_size_);
+    SPDLOG_DEBUG("dynamic table: current sz: {}, max: {}", entry_size, max_table_size_);
 }
 
 std::optional<size_t> DynamicTable::find(const HttpHeader& header) {
@@ -56,11 +56,13 @@ std::optional<size_t> DynamicTable::find_name(const std::string& name) {
 }
 
 void DynamicTable::log_contents() const {
-    spdlog::debug("dynamic table (size: {}, max: {}):", table_size_, max_table_size_);
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+    SPDLOG_DEBUG("dynamic table (size: {}, max: {}):", table_size_, max_table_size_);
     int pos = 0;
     for (const auto& header : table_) {
-        spdlog::debug(" - ({}) {}: {}", pos++, header.name, header.value);
+        SPDLOG_DEBUG(" - ({}) {}: {}", pos++, header.name, header.value);
     }
+#endif
 }
 
 int DynamicTable::size() const {
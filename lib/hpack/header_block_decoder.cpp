@@ -7,6 +7,7 @@
 #include "byte_reader.h"
 #include "header_field.h"
 #include "header_static_table.h"
+#include "header_validator.h"
 #include "huffman_codes.h"
 #include "huffman_tree.h"
 #include "int_decoder.h"
@@ -89,8 +90,8 @@ std::expected<HttpHeader, FrameError> HeaderBlockDecoder::read_indexed_header(si
     if (table_index < STATIC_TABLE.size()) {
         // static lookup
         auto hdr = STATIC_TABLE[table_index];
-        spdlog::trace("read indexed header from static table (idx: {}, name: {}, val: {})",
-                      table_index, hdr.name, hdr.value);
+        SPDLOG_TRACE("read indexed header from static table (idx: {}, name: {}, val: {})",
+                     table_index, hdr.name, hdr.value);
         return hdr.to_http_header();
     }
 
@@ -102,8 +103,8 @@ std::expected<HttpHeader, FrameError> HeaderBlockDecoder::read_indexed_header(si
         return std::unexpected(FrameError::ProtocolError);
     }
     auto hdr = dynamic_table_.get(dynamic_index);
-    spdlog::trace("read indexed header from dynamic table (idx: {}, name: {}, val: {})",
-                  dynamic_index, hdr.name, hdr.value);
+    SPDLOG_TRACE("read indexed header from dynamic table (idx: {}, name: {}, val: {})",
+                 dynamic_index, hdr.name, hdr.value);
     return hdr;
 }
 
@@ -112,8 +113,8 @@ std::expected<std::string, FrameError> HeaderBlockDecoder::read_indexed_header_n
     if (table_index < STATIC_TABLE.size()) {
         // static lookup
         auto name = STATIC_TABLE[table_index].name;
-        spdlog::trace("read indexed header name from static table (idx: {}, name: {})", table_index,
-                      name);
+        SPDLOG_TRACE("read indexed header name from static table (idx: {}, name: {})", table_index,
+                     name);
         return std::string(name);
     }
 
@@ -125,8 +126,8 @@ std::expected<std::string, FrameError> HeaderBlockDecoder::read_indexed_header_n
         return std::unexpected(FrameError::ProtocolError);
     }
     auto name = dynamic_table_.get(dynamic_index).name;
-    spdlog::trace("read indexed header name from dynamic table (idx: {}, name: {})", dynamic_index,
-                  name);
+    SPDLOG_TRACE("read indexed header name from dynamic table (idx: {}, name: {})", dynamic_index,
+                 name);
     return name;
 }
 
@@ -151,18 +152,28 @@ std::expected<HttpHeader, FrameError> HeaderBlockDecoder::decode_literal_field(
     }
 
     bool is_new_name = *index == 0;
-    spdlog::trace("decoding literal field with index: {}, new name: {}", *index, is_new_name);
+    SPDLOG_TRACE("decoding literal field with index: {}, new name: {}", *index, is_new_name);
     const auto name =
         is_new_name ? read_length_and_string(reader) : read_indexed_header_name(*index);
     if (!name) {
         return std::unexpected(FrameError::ProtocolError);
     }
+    // indexed names were validated when they entered the dynamic table
+    if (is_new_name && !HeaderValidator::is_valid_name(*name)) {
+        // the name is the peer's, so it's escaped and kept out of the default log level
+        SPDLOG_DEBUG("malformed header name: {:?}", *name);
+        return std::unexpected(FrameError::ProtocolError);
+    }
 
     auto value = read_length_and_string(reader);
     if (!value) {
         return std::unexpected(FrameError::ProtocolError);
     }
-    spdlog::trace("decoded header: name: {}, value: {}", name.value(), value.value());
+    if (!HeaderValidator::is_valid_value(*value)) {
+        SPDLOG_DEBUG("malformed value for header: {:?}", *name);
+        return std::unexpected(FrameError::ProtocolError);
+    }
+    SPDLOG_TRACE("decoded header: name: {}, value: {}", name.value(), value.value());
     return HttpHeader{name.value(), *value};
 }
 
@@ -181,57 +192,120 @@ std::expected<void, FrameError> HeaderBlockDecoder::decode_dynamic_table_size_up
     }
 
     dynamic_table_.set_max_table_size(*new_sz);
-    spdlog::trace("dynamic table size updated to: {}", *new_sz);
+    SPDLOG_TRACE("dynamic table size updated to: {}", *new_sz);
     return {};
 }
 
+// pseudo-header bits seen so far in a request header block
+static constexpr uint8_t SEEN_METHOD = 0x01;
+static constexpr uint8_t SEEN_PATH = 0x02;
+static constexpr uint8_t SEEN_SCHEME = 0x04;
+static constexpr uint8_t SEEN_AUTHORITY = 0x08;
+static constexpr uint8_t SEEN_REGULAR = 0x80;
+
+static bool store_pseudo_header(HttpHeader&& hdr, RequestPseudoHeaders& pseudo, uint8_t& seen) {
+    if (seen & SEEN_REGULAR) {
+        SPDLOG_DEBUG("pseudo-header field after regular fields: {:?}", hdr.name);
+        return false;
+    }
+
+    uint8_t bit = 0;
+    std::string* target = nullptr;
+    if (hdr.name == ":method") {
+        bit = SEEN_METHOD;
+        target = &pseudo.method_name;
+    } else if (hdr.name == ":path") {
+        bit = SEEN_PATH;
+        target = &pseudo.path;
+    } else if (hdr.name == ":scheme") {
+        bit = SEEN_SCHEME;
+        target = &pseudo.scheme;
+    } else if (hdr.name == ":authority") {
+        bit = SEEN_AUTHORITY;
+        target = &pseudo.authority;
+    } else {
+        SPDLOG_DEBUG("unknown request pseudo-header field: {:?}", hdr.name);
+        return false;
+    }
+
+    if (seen & bit) {
+        SPDLOG_DEBUG("duplicate pseudo-header field: {:?}", hdr.name);
+        return false;
+    }
+    seen |= bit;
+    *target = std::move(hdr.value);
+    if (bit == SEEN_METHOD) {
+        pseudo.method = HttpMethodHelper::from_string(pseudo.method_name);
+    }
+    return true;
+}
+
 std::expected<std::vector<HttpHeader>, FrameError> HeaderBlockDecoder::decode(
     std::span<const uint8_t> data) {
+    return decode_block(data, nullptr);
+}
+
+std::expected<std::vector<HttpHeader>, FrameError> HeaderBlockDecoder::decode(
+    std::span<const uint8_t> data, RequestPseudoHeaders& pseudo) {
+    return decode_block(data, &pseudo);
+}
+
+std::expected<std::vector<HttpHeader>, FrameError> HeaderBlockDecoder::decode_block(
+    std::span<const uint8_t> data, RequestPseudoHeaders* pseudo) {
     auto hdrs = std::vector<HttpHeader>{};
     ByteReader reader(data);
+    uint8_t seen = 0;
+
+    const auto store = [&](HttpHeader&& hdr) {
+        if (pseudo) {
+            if (hdr.name.starts_with(':')) {
+                return store_pseudo_header(std::move(hdr), *pseudo, seen);
+            }
+            seen |= SEEN_REGULAR;
+        }
+        hdrs.push_back(std::move(hdr));
+        return true;
+    };
 
     while (reader.has_bytes()) {
         uint8_t first_byte = *reader.peek_byte();
         auto type = HeaderField::from_byte(first_byte);
-        spdlog::trace("header type: {}, byte: 0x{:02X}", HeaderField::to_string(type), first_byte);
+        SPDLOG_TRACE("header type: {}, byte: 0x{:02X}", HeaderField::to_string(type), first_byte);
+        std::expected<HttpHeader, FrameError> hdr = std::unexpected(FrameError::ProtocolError);
         switch (type) {
             case HeaderFieldType::Indexed: {
-                if (auto hdr = decode_indexed_field(reader)) {
-                    hdrs.push_back(*hdr);
-                } else {
-                    return std::unexpected(hdr.error());
-                }
+                hdr = decode_indexed_field(reader);
                 break;
             }
             case HeaderFieldType::LiteralIncremental: {
-                if (auto hdr = decode_literal_field(6, reader)) {
-                    dynamic_table_.insert(hdr.value());
-                    hdrs.push_back(hdr.value());
-                } else {
-                    return std::unexpected(hdr.error());
+                hdr = decode_literal_field(6, reader);
+                if (hdr) {
+                    dynamic_table_.insert(*hdr);
                 }
                 break;
             }
             case HeaderFieldType::LiteralNoIndex:
             case HeaderFieldType::LiteralNeverIndex: {
-                if (auto hdr = decode_literal_field(4, reader)) {
-                    hdrs.push_back(hdr.value());
-                } else {
-                    return std::unexpected(hdr.error());
-                }
+                hdr = decode_literal_field(4, reader);
                 break;
             }
             case HeaderFieldType::SizeUpdate: {
                 if (auto res = decode_dynamic_table_size_update(reader); !res) {
                     return std::unexpected(res.error());
                 }
-                break;
+                continue;
             }
             case HeaderFieldType::Invalid: {
                 spdlog::error("invalid first byte in header representation: {}", first_byte);
                 return std::unexpected(FrameError::ProtocolError);
             }
         }
+        if (!hdr) {
+            return std::unexpected(hdr.error());
+        }
+        if (!store(std::move(*hdr))) {
+            return std::unexpected(FrameError::ProtocolError);
+        }
     }
     return hdrs;
 }
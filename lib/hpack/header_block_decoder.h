@@ -8,6 +8,7 @@
 #include "frame_error.h"
 #include "http_header.h"
 #include "huffman_tree.h"
+#include "request_pseudo_headers.h"
 
 namespace ion {
 
@@ -16,6 +17,9 @@ class HeaderBlockDecoder {
     explicit HeaderBlockDecoder(DynamicTable& dynamic_table);
 
     std::expected<std::vector<HttpHeader>, FrameError> decode(std::span<const uint8_t> data);
+    // Moves request pseudo-headers into `pseudo` and returns only the regular fields.
+    std::expected<std::vector<HttpHeader>, FrameError> decode(std::span<const uint8_t> data,
+                                                              RequestPseudoHeaders& pseudo);
 
    private:
     DynamicTable& dynamic_table_;
@@ -33,6 +37,8 @@ class HeaderBlockDecoder {
     std::expected<std::string, FrameError> read_indexed_header_name(size_t index);
     std::expected<HttpHeader, FrameError> read_indexed_header(size_t index);
     std::expected<void, FrameError> decode_dynamic_table_size_update(ByteReader& reader);
+    std::expected<std::vector<HttpHeader>, FrameError> decode_block(std::span<const uint8_t> data,
+                                                                    RequestPseudoHeaders* pseudo);
 };
 
 }  // namespace ion
@@ -13,8 +13,16 @@ namespace ion {
 
 static constexpr size_t MAX_PLAIN_TEXT_STRING_LENGTH = 3;
 
-HeaderBlockEncoder::HeaderBlockEncoder(DynamicTable& dynamic_table)
-    : dynamic_table_(dynamic_table) {}
+static void write_int(uint32_t value, uint8_t prefix_bits, uint8_t pattern,
+                      std::vector<uint8_t>& bytes) {
+    const auto encoded = IntegerEncoder::encode(value, prefix_bits);
+    bytes.push_back(pattern | encoded[0]);
+    bytes.insert(bytes.end(), encoded.begin() + 1, encoded.end());
+}
+
+HeaderBlockEncoder::HeaderBlockEncoder(DynamicTable& dynamic_table,
+                                       const IndexingPolicyConfig& indexing_config)
+    : dynamic_table_(dynamic_table), indexing_policy_(indexing_config) {}
 
 std::vector<uint8_t> HeaderBlockEncoder::write_length_and_string(const std::string& str) {
     std::vector<uint8_t> bytes{};
@@ -50,74 +58,143 @@ std::vector<uint8_t> HeaderBlockEncoder::write_length_and_string(const std::stri
     return bytes;
 }
 
+void HeaderBlockEncoder::encode_literal(const HttpHeader& hdr, std::optional<size_t> name_index,
+                                        std::vector<uint8_t>& bytes) {
+    const auto type = indexing_policy_.literal_type(hdr);
+    indexing_policy_.record_miss(hdr.name);
+
+    const auto index = static_cast<uint32_t>(name_index.value_or(0));
+    switch (type) {
+        case HeaderFieldType::LiteralIncremental:
+            write_int(index, 6, 0x40, bytes);
+            break;
+        case HeaderFieldType::LiteralNeverIndex:
+            write_int(index, 4, 0x10, bytes);
+            break;
+        default:
+            write_int(index, 4, 0x00, bytes);
+            break;
+    }
+
+    if (!name_index) {
+        const auto name_len_and_str_bytes = write_length_and_string(hdr.name);
+        bytes.insert(bytes.end(), name_len_and_str_bytes.begin(), name_len_and_str_bytes.end());
+    }
+    const auto value_len_and_str_bytes = write_length_and_string(hdr.value);
+    bytes.insert(bytes.end(), value_len_and_str_bytes.begin(), value_len_and_str_bytes.end());
+
+    if (type == HeaderFieldType::LiteralIncremental) {
+        dynamic_table_.insert(hdr);
+    }
+}
+
+void HeaderBlockEncoder::encode_header(const HttpHeader& hdr, std::vector<uint8_t>& bytes) {
+    // is static header?
+    const auto st_it = std::find_if(
+        STATIC_TABLE.begin(), STATIC_TABLE.end(), [&hdr](const StaticHttpHeader& header) {
+            return header.name == hdr.name && header.value == hdr.value;
+        });
+
+    if (st_it != STATIC_TABLE.end()) {
+        // found static header
+        const size_t table_index = std::distance(STATIC_TABLE.begin(), st_it);
+        write_int(table_index + 1, 7, 0x80, bytes);
+        return;
+    }
+
+    // check dynamic headers too
+    if (auto dyn_table_index = dynamic_table_.find(hdr)) {
+        indexing_policy_.record_hit(hdr.name);
+        write_int(STATIC_TABLE.size() + dyn_table_index.value() + 1, 7, 0x80, bytes);
+        return;
+    }
+
+    // is static field header name?
+    const auto st_name_it =
+        std::find_if(STATIC_TABLE.begin(), STATIC_TABLE.end(),
+                     [&hdr](const StaticHttpHeader& header) { return header.name == hdr.name; });
+
+    if (st_name_it != STATIC_TABLE.end()) {
+        const size_t table_index = std::distance(STATIC_TABLE.begin(), st_name_it);
+        encode_literal(hdr, table_index + 1, bytes);
+        return;
+    }
+
+    // is dynamic field header name?
+    if (auto dyn_table_index = dynamic_table_.find_name(hdr.name)) {
+        encode_literal(hdr, STATIC_TABLE.size() + dyn_table_index.value() + 1, bytes);
+        return;
+    }
+
+    // new name
+    encode_literal(hdr, std::nullopt, bytes);
+}
+
 std::vector<uint8_t> HeaderBlockEncoder::encode(const std::vector<HttpHeader>& headers) {
     std::vector<uint8_t> bytes{};
     for (auto& hdr : headers) {
+        encode_header(hdr, bytes);
+    }
+    return bytes;
+}
+
+std::vector<uint8_t> HeaderBlockEncoder::encode(
+    const std::vector<HttpHeader>& headers,
+    std::initializer_list<const PreEncodedHeaders*> pre_encoded) {
+    auto bytes = encode(headers);
+
+    size_t total_size = bytes.size();
+    for (const auto* fragment : pre_encoded) {
+        if (fragment) {
+            total_size += fragment->bytes.size();
+        }
+    }
+    bytes.reserve(total_size);
+
+    for (const auto* fragment : pre_encoded) {
+        if (fragment) {
+            bytes.insert(bytes.end(), fragment->bytes.begin(), fragment->bytes.end());
+        }
+    }
+    return bytes;
+}
+
+PreEncodedHeaders HeaderBlockEncoder::pre_encode(const std::vector<HttpHeader>& headers) {
+    PreEncodedHeaders pre_encoded{.headers = headers};
+    auto& bytes = pre_encoded.bytes;
+
+    for (const auto& hdr : headers) {
         // is static header?
         const auto st_it = std::find_if(
-            STATIC_TABLE.begin(), STATIC_TABLE.end(), [hdr](const StaticHttpHeader& header) {
+            STATIC_TABLE.begin(), STATIC_TABLE.end(), [&hdr](const StaticHttpHeader& header) {
                 return header.name == hdr.name && header.value == hdr.value;
             });
 
         if (st_it != STATIC_TABLE.end()) {
-            // found static header
-            const size_t table_index = std::distance(STATIC_TABLE.begin(), st_it);
-            const size_t index = table_index + 1;
-            bytes.push_back(static_cast<uint8_t>(index | 0x80));
-            continue;
-        }
-
-        // check dynamic headers too
-        if (auto dyn_table_index = dynamic_table_.find(hdr)) {
-            const size_t index = STATIC_TABLE.size() + dyn_table_index.value() + 1;
-            bytes.push_back(static_cast<uint8_t>(index | 0x80));
+            const size_t index = std::distance(STATIC_TABLE.begin(), st_it) + 1;
+            write_int(index, 7, 0x80, bytes);
             continue;
         }
 
-        // is static field header name?
+        // literal without indexing, so the dynamic table is never referenced or modified
         const auto st_name_it =
             std::find_if(STATIC_TABLE.begin(), STATIC_TABLE.end(),
-                         [hdr](const StaticHttpHeader& header) { return header.name == hdr.name; });
+                         [&hdr](const StaticHttpHeader& header) { return header.name == hdr.name; });
 
         if (st_name_it != STATIC_TABLE.end()) {
-            const size_t table_index = std::distance(STATIC_TABLE.begin(), st_name_it);
-            const size_t index = table_index + 1;
-            bytes.push_back(static_cast<uint8_t>(index | 0x40));
-
-            // encode string
-            const auto len_and_str_bytes = write_length_and_string(hdr.value);
-            bytes.insert(bytes.end(), len_and_str_bytes.begin(), len_and_str_bytes.end());
-
-            // insert into dynamic table
-            dynamic_table_.insert(hdr);
-            continue;
+            const size_t index = std::distance(STATIC_TABLE.begin(), st_name_it) + 1;
+            write_int(index, 4, 0x00, bytes);
+        } else {
+            bytes.push_back(0x00);
+            const auto name_len_and_str_bytes = write_length_and_string(hdr.name);
+            bytes.insert(bytes.end(), name_len_and_str_bytes.begin(),
+                         name_len_and_str_bytes.end());
         }
 
-        // is dynamic field header name?
-        if (auto dyn_table_index = dynamic_table_.find_name(hdr.name)) {
-            const size_t index = STATIC_TABLE.size() + dyn_table_index.value() + 1;
-            bytes.push_back(static_cast<uint8_t>(index | 0x40));
-
-            // encode string
-            const auto len_and_str_bytes = write_length_and_string(hdr.value);
-            bytes.insert(bytes.end(), len_and_str_bytes.begin(), len_and_str_bytes.end());
-
-            // insert into dynamic table
-            dynamic_table_.insert(hdr);
-            continue;
-        }
-
-        // new name
-        const auto name_len_and_str_bytes = write_length_and_string(hdr.name);
         const auto value_len_and_str_bytes = write_length_and_string(hdr.value);
-        bytes.push_back(0x40);
-        bytes.insert(bytes.end(), name_len_and_str_bytes.begin(), name_len_and_str_bytes.end());
         bytes.insert(bytes.end(), value_len_and_str_bytes.begin(), value_len_and_str_bytes.end());
-
-        // insert into dynamic table
-        dynamic_table_.insert(hdr);
     }
-    return bytes;
+    return pre_encoded;
 }
 
 }  // namespace ion
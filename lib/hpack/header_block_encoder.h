@@ -1,20 +1,36 @@
 #pragma once
 #include <cstdint>
+#include <initializer_list>
+#include <optional>
 #include <vector>
 
 #include "dynamic_table.h"
+#include "indexing_policy.h"
+#include "pre_encoded_headers.h"
 
 namespace ion {
 
 class HeaderBlockEncoder {
    public:
-    explicit HeaderBlockEncoder(DynamicTable& dynamic_table);
+    explicit HeaderBlockEncoder(
+        DynamicTable& dynamic_table,
+        const IndexingPolicyConfig& indexing_config = DEFAULT_INDEXING_POLICY_CONFIG);
+    // the config is referenced, not copied, so it must outlive the encoder
+    HeaderBlockEncoder(DynamicTable& dynamic_table, const IndexingPolicyConfig&& indexing_config) =
+        delete;
     std::vector<uint8_t> encode(const std::vector<HttpHeader>& headers);
+    std::vector<uint8_t> encode(const std::vector<HttpHeader>& headers,
+                                std::initializer_list<const PreEncodedHeaders*> pre_encoded);
+    static PreEncodedHeaders pre_encode(const std::vector<HttpHeader>& headers);
 
    private:
-    std::vector<uint8_t> write_length_and_string(const std::string& str);
+    static std::vector<uint8_t> write_length_and_string(const std::string& str);
+    void encode_header(const HttpHeader& hdr, std::vector<uint8_t>& bytes);
+    void encode_literal(const HttpHeader& hdr, std::optional<size_t> name_index,
+                        std::vector<uint8_t>& bytes);
 
     DynamicTable& dynamic_table_;
+    IndexingPolicy indexing_policy_;
 };
 
 }  // namespace ion
@@ -0,0 +1,157 @@
+#include "header_validator.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace ion {
+
+using ScanFn = size_t (*)(std::string_view);
+
+// lowercase "tchar" from RFC 9110 section 5.6.2
+static constexpr std::array<bool, 256> make_name_char_table() {
+    std::array<bool, 256> table{};
+    for (char c = 'a'; c <= 'z'; c++) {
+        table[static_cast<uint8_t>(c)] = true;
+    }
+    for (char c = '0'; c <= '9'; c++) {
+        table[static_cast<uint8_t>(c)] = true;
+    }
+    for (const char c : std::string_view{"!#$%&'*+-.^_`|~"}) {
+        table[static_cast<uint8_t>(c)] = true;
+    }
+    return table;
+}
+
+static constexpr auto NAME_CHARS = make_name_char_table();
+
+static bool is_forbidden_value_char(uint8_t c) {
+    return c == '\0' || c == '\r' || c == '\n';
+}
+
+static size_t scan_name_scalar(std::string_view str, size_t pos) {
+    for (; pos < str.size(); pos++) {
+        if (!NAME_CHARS[static_cast<uint8_t>(str[pos])]) {
+            return pos;
+        }
+    }
+    return str.size();
+}
+
+static size_t scan_value_scalar(std::string_view str, size_t pos) {
+    for (; pos < str.size(); pos++) {
+        if (is_forbidden_value_char(static_cast<uint8_t>(str[pos]))) {
+            return pos;
+        }
+    }
+    return str.size();
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) static size_t scan_name_sse42(std::string_view str) {
+    // pairs of inclusive ranges covering exactly the lowercase tchar set
+    alignas(16) static constexpr char ranges[16] = {'!', '!', '#', '\'', '*', '+', '-', '.',
+                                                    '0', '9', '^', 'z', '|', '|', '~', '~'};
+    const __m128i ranges_vec = _mm_load_si128(reinterpret_cast<const __m128i*>(ranges));
+
+    size_t pos = 0;
+    for (; pos + 16 <= str.size(); pos += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str.data() + pos));
+        const int idx = _mm_cmpestri(ranges_vec, 16, chunk, 16,
+                                     _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_NEGATIVE_POLARITY);
+        if (idx != 16) {
+            return pos + idx;
+        }
+    }
+    return scan_name_scalar(str, pos);
+}
+
+static size_t scan_value_sse2(std::string_view str, size_t pos) {
+    const __m128i nul = _mm_setzero_si128();
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+
+    for (; pos + 16 <= str.size(); pos += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str.data() + pos));
+        const __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, nul), _mm_cmpeq_epi8(chunk, cr)),
+            _mm_cmpeq_epi8(chunk, lf));
+        if (const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(hits))) {
+            return pos + std::countr_zero(mask);
+        }
+    }
+    return scan_value_scalar(str, pos);
+}
+
+__attribute__((target("avx2"))) static size_t scan_value_avx2(std::string_view str) {
+    const __m256i nul = _mm256_setzero_si256();
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+
+    size_t pos = 0;
+    for (; pos + 32 <= str.size(); pos += 32) {
+        const __m256i chunk =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str.data() + pos));
+        const __m256i hits = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, nul), _mm256_cmpeq_epi8(chunk, cr)),
+            _mm256_cmpeq_epi8(chunk, lf));
+        if (const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits))) {
+            return pos + std::countr_zero(mask);
+        }
+    }
+    return scan_value_sse2(str, pos);
+}
+#endif
+
+static ScanFn select_name_scanner() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        return scan_name_sse42;
+    }
+#endif
+    return [](std::string_view str) { return scan_name_scalar(str, 0); };
+}
+
+static ScanFn select_value_scanner() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return scan_value_avx2;
+    }
+    return [](std::string_view str) { return scan_value_sse2(str, 0); };
+#else
+    return [](std::string_view str) { return scan_value_scalar(str, 0); };
+#endif
+}
+
+static const ScanFn scan_name = select_name_scanner();
+static const ScanFn scan_value = select_value_scanner();
+
+bool HeaderValidator::is_valid_name(std::string_view name) {
+    // pseudo-header fields carry a single leading colon
+    if (name.starts_with(':')) {
+        name.remove_prefix(1);
+    }
+    if (name.empty()) {
+        return false;
+    }
+    return scan_name(name) == name.size();
+}
+
+bool HeaderValidator::is_valid_value(std::string_view value) {
+    if (value.empty()) {
+        return true;
+    }
+    if (value.front() == ' ' || value.front() == '\t' || value.back() == ' ' ||
+        value.back() == '\t') {
+        return false;
+    }
+    return scan_value(value) == value.size();
+}
+
+}  // namespace ion
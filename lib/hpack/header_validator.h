@@ -0,0 +1,14 @@
+#pragma once
+#include <string_view>
+
+namespace ion {
+
+// RFC 9113 section 8.2.1 field validity checks. Uses SSE4.2/AVX2 kernels where the CPU supports
+// them (selected at startup), otherwise a scalar lookup.
+class HeaderValidator {
+   public:
+    static bool is_valid_name(std::string_view name);
+    static bool is_valid_value(std::string_view value);
+};
+
+}  // namespace ion
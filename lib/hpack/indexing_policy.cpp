@@ -0,0 +1,75 @@
+#include "indexing_policy.h"
+
+#include <spdlog/spdlog.h>
+
+namespace ion {
+
+static constexpr size_t MAX_TRACKED_NAMES = 128;
+static constexpr size_t ENTRY_OVERHEAD = 32;
+
+IndexingPolicy::IndexingPolicy(const IndexingPolicyConfig& config) : config_(&config) {}
+
+HeaderFieldType IndexingPolicy::literal_type(const HttpHeader& header) const {
+    if (config_->never_index_names.contains(header.name)) {
+        return HeaderFieldType::LiteralNeverIndex;
+    }
+    if (config_->no_index_names.contains(header.name)) {
+        return HeaderFieldType::LiteralNoIndex;
+    }
+    if (header.name.size() + header.value.size() + ENTRY_OVERHEAD >
+        config_->max_indexed_entry_size) {
+        return HeaderFieldType::LiteralNoIndex;
+    }
+    if (is_volatile(header.name)) {
+        return HeaderFieldType::LiteralNoIndex;
+    }
+    return HeaderFieldType::LiteralIncremental;
+}
+
+void IndexingPolicy::record_hit(const std::string& name) {
+    if (const auto it = stats_.find(name); it != stats_.end()) {
+        start_over_if_full(it->second);
+        it->second.hits++;
+    }
+}
+
+void IndexingPolicy::record_miss(const std::string& name) {
+    if (const auto it = stats_.find(name); it != stats_.end()) {
+        start_over_if_full(it->second);
+        it->second.misses++;
+        return;
+    }
+    if (stats_.size() >= MAX_TRACKED_NAMES) {
+        return;
+    }
+    stats_.emplace(name, NameStats{.misses = 1});
+}
+
+// volatile names are no longer indexed, so they can't hit; starting over is the only way back
+void IndexingPolicy::start_over_if_full(NameStats& stats) const {
+    if (stats.hits + stats.misses >= config_->sample_window) {
+        stats = {};
+    }
+}
+
+bool IndexingPolicy::is_volatile(const std::string& name) const {
+    const auto it = stats_.find(name);
+    if (it == stats_.end()) {
+        return false;
+    }
+
+    const auto& [hits, misses] = it->second;
+    const auto samples = hits + misses;
+    if (samples < config_->min_samples) {
+        return false;
+    }
+
+    const bool is_volatile = static_cast<double>(hits) / samples < config_->min_hit_ratio;
+    if (is_volatile) {
+        SPDLOG_TRACE("indexing policy: '{}' is volatile (hits: {}, misses: {})", name, hits,
+                     misses);
+    }
+    return is_volatile;
+}
+
+}  // namespace ion
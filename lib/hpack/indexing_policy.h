@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "header_field.h"
+#include "http_header.h"
+
+namespace ion {
+
+struct IndexingPolicyConfig {
+    // sensitive headers that intermediaries must never index (RFC 7541 section 7.1.3)
+    std::unordered_set<std::string> never_index_names{"authorization", "cookie",
+                                                      "proxy-authorization", "set-cookie"};
+    // headers whose values change on (almost) every response
+    std::unordered_set<std::string> no_index_names{
+        "age", "content-length", "content-range", "date", "etag", "expires", "last-modified"};
+    size_t max_indexed_entry_size = 512;
+    uint32_t min_samples = 8;
+    double min_hit_ratio = 0.25;
+    // a name's counts start over after this many samples, so a volatile name gets indexed
+    // again for a while and can turn out to be stable after all
+    uint32_t sample_window = 256;
+};
+
+inline const IndexingPolicyConfig DEFAULT_INDEXING_POLICY_CONFIG{};
+
+// Chooses how the encoder represents literal headers. The config is shared (normally the
+// server's ServerConfiguration::hpack_indexing) and must outlive the policy; only the hit
+// counts are kept per policy.
+class IndexingPolicy {
+   public:
+    explicit IndexingPolicy(const IndexingPolicyConfig& config = DEFAULT_INDEXING_POLICY_CONFIG);
+    // a temporary config would be gone before the policy is used
+    explicit IndexingPolicy(const IndexingPolicyConfig&& config) = delete;
+
+    [[nodiscard]] HeaderFieldType literal_type(const HttpHeader& header) const;
+    void record_hit(const std::string& name);
+    void record_miss(const std::string& name);
+
+   private:
+    struct NameStats {
+        uint32_t hits{};
+        uint32_t misses{};
+    };
+
+    // a pointer rather than a reference so policies can be reassigned
+    const IndexingPolicyConfig* config_;
+    std::unordered_map<std::string, NameStats> stats_{};
+
+    void start_over_if_full(NameStats& stats) const;
+    [[nodiscard]] bool is_volatile(const std::string& name) const;
+};
+
+}  // namespace ion
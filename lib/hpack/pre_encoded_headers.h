@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "http_header.h"
+
+namespace ion {
+
+// Header block fragment encoded ahead of time using only the static table and literals without
+// indexing, so it is valid on any connection regardless of its dynamic table state.
+struct PreEncodedHeaders {
+    std::vector<HttpHeader> headers{};
+    std::vector<uint8_t> bytes{};
+};
+
+}  // namespace ion
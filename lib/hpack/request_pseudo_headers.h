@@ -0,0 +1,18 @@
+#pragma once
+#include <string>
+
+#include "http_method.h"
+
+namespace ion {
+
+// Request pseudo-header fields (RFC 9113 section 8.3.1), captured into typed fields while a
+// header block is decoded instead of being left in the header list.
+struct RequestPseudoHeaders {
+    HttpMethod method{HttpMethod::Other};
+    std::string method_name{};
+    std::string path{};
+    std::string scheme{};
+    std::string authority{};
+};
+
+}  // namespace ion
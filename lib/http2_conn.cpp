@@ -2,13 +2,17 @@
 
 #include <opentelemetry/trace/provider.h>
 #include <spdlog/spdlog.h>
+#include <unistd.h>
 
-#include <format>
+#include <algorithm>
 
 #include "access_log.h"
+#include "buffer_pool.h"
 #include "hpack/header_block_decoder.h"
 #include "http2_frame_reader.h"
 #include "http2_server.h"
+#include "system_clock.h"
+#include "trace_parent.h"
 #include "version.h"
 
 namespace ion {
@@ -17,6 +21,7 @@ static constexpr std::string_view CLIENT_PREFACE{"PRI * HTTP/2.0\r\n\r\nSM\r\n\r
 
 static constexpr uint8_t FRAME_TYPE_DATA = 0x00;
 static constexpr uint8_t FRAME_TYPE_HEADERS = 0x01;
+static constexpr uint8_t FRAME_TYPE_RST_STREAM = 0x03;
 static constexpr uint8_t FRAME_TYPE_SETTINGS = 0x04;
 static constexpr uint8_t FRAME_TYPE_GOAWAY = 0x07;
 static constexpr uint8_t FRAME_TYPE_WINDOW_UPDATE = 0x08;
@@ -26,19 +31,66 @@ static constexpr uint8_t FLAG_END_STREAM = 0x01;
 
 static constexpr size_t MAX_READ_BUFFER_SIZE = 64 * 1024;
 static constexpr size_t MAX_FRAME_SIZE = 16384;
-static constexpr size_t INITIAL_READ_BUFFER_SIZE = 16 * 1024;
-static constexpr size_t INITIAL_WRITE_BUFFER_SIZE = 16 * 1024;
+// DATA frames are never larger than this, whatever the peer allows, so a buffered file frame
+// stays small
+static constexpr size_t MAX_DATA_FRAME_SIZE = 64 * 1024;
 static constexpr size_t TEMP_READ_BUFFER_SIZE = 16 * 1024;
+static constexpr int64_t MAX_WINDOW_SIZE = 0x7FFFFFFF;
+static constexpr uint32_t MAX_MAX_FRAME_SIZE = 0xFFFFFF;
+static constexpr uint16_t SETTINGS_INITIAL_WINDOW_SIZE = 0x0004;
+static constexpr uint16_t SETTINGS_MAX_FRAME_SIZE = 0x0005;
 
 static constexpr std::chrono::seconds IDLE_TIMEOUT{5};
+// for connections waiting on the peer to open a flow-control window, which aren't idle but
+// shouldn't be held forever either
+static constexpr std::chrono::seconds FLOW_CONTROL_STALL_TIMEOUT{60};
+
+static const PreEncodedHeaders SERVER_HEADERS = HeaderBlockEncoder::pre_encode({
+    {"server", std::string{SERVER_HEADER}},
+    {"x-powered-by", std::string{SERVER_HEADER}},
+});
+
+// looked up once per event loop thread rather than per request; the tracer provider is
+// installed before the server starts
+static opentelemetry::trace::Tracer& request_tracer() {
+    thread_local const auto tracer =
+        opentelemetry::trace::Provider::GetTracerProvider()->GetTracer("ion");
+    return *tracer;
+}
 
-Http2Connection::Http2Connection(std::unique_ptr<Transport> transport, const std::string& client_ip,
-                                 const Router& router)
-    : transport_(std::move(transport)), client_ip_(client_ip), router_(router) {
-    read_buffer_.reserve(INITIAL_READ_BUFFER_SIZE);
-    write_buffer_.reserve(INITIAL_WRITE_BUFFER_SIZE);
+// attribute values are copied by the SDK, so there's no need to build a std::string first
+static opentelemetry::nostd::string_view attribute_view(std::string_view value) {
+    return {value.data(), value.size()};
+}
+
+// re-encoded at most once per second on each event loop thread
+static const PreEncodedHeaders* date_header(const HttpResponse& resp) {
+    const auto has_date = [](const std::vector<HttpHeader>& headers) {
+        return std::ranges::find(headers, "date", &HttpHeader::name) != headers.end();
+    };
+    if (has_date(resp.headers) ||
+        (resp.pre_encoded_headers && has_date(resp.pre_encoded_headers->headers))) {
+        return nullptr;
+    }
+
+    thread_local PreEncodedHeaders cached{};
+    const auto now = SystemClock::http_date();
+    if (cached.headers.empty() || cached.headers.front().value != now) {
+        cached = HeaderBlockEncoder::pre_encode({{"date", std::string{now}}});
+    }
+    return &cached;
 }
 
+Http2Connection::Http2Connection(std::unique_ptr<Transport> transport, const std::string& client_ip,
+                                 const RequestDispatcher& dispatcher,
+                                 const IndexingPolicyConfig& indexing_config,
+                                 const RequestSampler& sampler)
+    : transport_(std::move(transport)),
+      client_ip_(client_ip),
+      dispatcher_(dispatcher),
+      sampler_(sampler),
+      encoder_(encoder_dynamic_table_, indexing_config) {}
+
 Http2WindowUpdate Http2Connection::process_window_update_payload(std::span<const uint8_t> payload) {
     return Http2WindowUpdate::parse(payload.subspan<0, Http2WindowUpdate::wire_size>());
 }
@@ -82,31 +134,6 @@ void Http2Connection::write_headers_response(uint32_t stream_id,
     enqueue_write(headers_data);
 }
 
-void Http2Connection::write_data_response(uint32_t stream_id, const std::vector<uint8_t>& body) {
-    size_t remaining_bytes = body.size();
-    size_t start = 0;
-
-    while (remaining_bytes != 0) {
-        size_t chunk_size = std::min(remaining_bytes, MAX_FRAME_SIZE - 128);
-        remaining_bytes -= chunk_size;
-
-        const Http2FrameHeader frame_header{
-            .length = static_cast<uint32_t>(chunk_size),
-            .type = FRAME_TYPE_DATA,
-            .flags = remaining_bytes == 0 ? FLAG_END_STREAM : static_cast<uint8_t>(0),
-            .stream_id = stream_id};
-
-        write_frame_header(frame_header);
-
-        spdlog::trace("enqueuing data frame for write (size: {}, rem: {})", chunk_size,
-                      remaining_bytes);
-
-        enqueue_write(std::span(body.data() + start, chunk_size));
-
-        start += chunk_size;
-    }
-}
-
 void Http2Connection::write_goaway(uint32_t last_stream_id, ErrorCode error_code) {
     const Http2GoAwayPayload payload{.last_stream_id = last_stream_id,
                                      .error_code = static_cast<uint32_t>(error_code)};
@@ -123,18 +150,31 @@ void Http2Connection::write_goaway(uint32_t last_stream_id, ErrorCode error_code
     enqueue_write(payload_bytes);
 }
 
+void Http2Connection::write_rst_stream(uint32_t stream_id, ErrorCode error_code) {
+    const Http2FrameHeader header{.length = Http2RstStream::wire_size,
+                                  .type = FRAME_TYPE_RST_STREAM,
+                                  .flags = 0x00,
+                                  .stream_id = stream_id};
+
+    write_frame_header(header);
+
+    std::array<uint8_t, Http2RstStream::wire_size> payload_bytes{};
+    Http2RstStream{.error_code = static_cast<uint32_t>(error_code)}.serialize(payload_bytes);
+    enqueue_write(payload_bytes);
+}
+
 void Http2Connection::write_settings() {
     const std::vector<Http2Setting> settings = {{0x0003, 100},    // MAX_CONCURRENT_STREAMS
                                                 {0x0004, 65535},  // INITIAL_WINDOW_SIZE
                                                 {0x0005, MAX_FRAME_SIZE}};
     write_settings(settings);
-    spdlog::debug("SETTINGS frame sent");
+    SPDLOG_DEBUG("SETTINGS frame sent");
 }
 
 void Http2Connection::fill_read_buffer() {
     while (true) {
         if (read_buffer_.size() + TEMP_READ_BUFFER_SIZE >= MAX_READ_BUFFER_SIZE) {
-            spdlog::debug("read buffer full");
+            SPDLOG_DEBUG("read buffer full");
             return;
         }
 
@@ -144,10 +184,10 @@ void Http2Connection::fill_read_buffer() {
         if (!bytes_read_res) {
             switch (bytes_read_res.error()) {
                 case TransportError::WantReadOrWrite:
-                    spdlog::trace("transport want read/write");
+                    SPDLOG_TRACE("transport want read/write");
                     break;
                 case TransportError::ConnectionClosed:
-                    spdlog::debug("transport connection closed");
+                    SPDLOG_DEBUG("transport connection closed");
                     update_state(Http2ConnectionState::ClientClosed);
                     break;
                 case TransportError::ProtocolError:
@@ -165,19 +205,26 @@ void Http2Connection::fill_read_buffer() {
         }
         const auto bytes_read = *bytes_read_res;
         update_last_activity();
+        metrics_.add_received(static_cast<uint64_t>(bytes_read));
+        if (read_buffer_.capacity() == 0) {
+            read_buffer_ = BufferPool::local().acquire();
+        }
         read_buffer_.insert(read_buffer_.end(), buffer.begin(), buffer.begin() + bytes_read);
-        spdlog::trace("read {} bytes, buffer size now {}", bytes_read, read_buffer_.size());
+        SPDLOG_TRACE("read {} bytes, buffer size now {}", bytes_read, read_buffer_.size());
     }
 }
 
 void Http2Connection::discard_processed_buffer(size_t length) {
     read_buffer_.erase(read_buffer_.begin(), read_buffer_.begin() + length);
+    if (read_buffer_.empty()) {
+        BufferPool::local().release(read_buffer_);
+    }
 }
 
 ReadPrefaceResult Http2Connection::read_preface() {
     if (read_buffer_.size() < CLIENT_PREFACE.length()) {
-        spdlog::trace("not enough data for preface ({} < {})", read_buffer_.size(),
-                      CLIENT_PREFACE.length());
+        SPDLOG_TRACE("not enough data for preface ({} < {})", read_buffer_.size(),
+                     CLIENT_PREFACE.length());
         return ReadPrefaceResult::NotEnoughData;
     }
     std::span<const uint8_t, CLIENT_PREFACE.size()> preface_span{read_buffer_.data(),
@@ -189,7 +236,7 @@ ReadPrefaceResult Http2Connection::read_preface() {
         return ReadPrefaceResult::ProtocolError;
     }
 
-    spdlog::info("valid HTTP/2 preface received");
+    SPDLOG_DEBUG("valid HTTP/2 preface received");
     write_settings();
     update_state(Http2ConnectionState::AwaitingFrame);
     discard_processed_buffer(CLIENT_PREFACE.size());
@@ -198,15 +245,15 @@ ReadPrefaceResult Http2Connection::read_preface() {
 
 bool Http2Connection::try_read_frame() {
     if (read_buffer_.size() < Http2FrameHeader::wire_size) {
-        spdlog::trace("not enough data for frame header ({} < {})", read_buffer_.size(),
-                      Http2FrameHeader::wire_size);
+        SPDLOG_TRACE("not enough data for frame header ({} < {})", read_buffer_.size(),
+                     Http2FrameHeader::wire_size);
         return false;
     }
 
     std::span<const uint8_t> buffer{read_buffer_};
     const auto header = Http2FrameHeader::parse(buffer.subspan<0, Http2FrameHeader::wire_size>());
-    spdlog::debug("received frame header: type: {}, flag: {:#04x}, length: {}", header.type,
-                  header.flags, header.length);
+    SPDLOG_DEBUG("received frame header: type: {}, flag: {:#04x}, length: {}", header.type,
+                 header.flags, header.length);
     if (header.length > MAX_FRAME_SIZE) {
         spdlog::warn("frame too big (sz: {}, max: {})", header.length, MAX_FRAME_SIZE);
         update_state(Http2ConnectionState::ProtocolError);
@@ -215,8 +262,8 @@ bool Http2Connection::try_read_frame() {
 
     const size_t total_frame_size = Http2FrameHeader::wire_size + header.length;
     if (read_buffer_.size() < total_frame_size) {
-        spdlog::trace("not enough data for whole frame ({} < {})", read_buffer_.size(),
-                      total_frame_size);
+        SPDLOG_TRACE("not enough data for whole frame ({} < {})", read_buffer_.size(),
+                     total_frame_size);
         return false;
     }
 
@@ -229,75 +276,148 @@ bool Http2Connection::try_read_frame() {
 void Http2Connection::process_frame(const Http2FrameReader& frame) {
     switch (frame.type()) {
         case FRAME_TYPE_SETTINGS: {
-            spdlog::debug("received SETTINGS frame (stream={} flags={})", frame.stream_id(),
-                          frame.flags());
+            SPDLOG_DEBUG("received SETTINGS frame (stream={} flags={})", frame.stream_id(),
+                         frame.flags());
             if (frame.has_flag(0x01)) {
-                spdlog::debug("received SETTINGS ACK");
+                SPDLOG_DEBUG("received SETTINGS ACK");
             } else {
                 auto settings = frame.read_settings();
                 if (!settings) {
                     update_state(Http2ConnectionState::ProtocolError);
                     return;
                 }
-                spdlog::debug("read {} settings, sending ACK", settings->size());
+                SPDLOG_DEBUG("read {} settings, sending ACK", settings->size());
+                process_settings(*settings);
                 write_settings_ack();
             }
             break;
         }
         case FRAME_TYPE_HEADERS: {
-            auto tracer = opentelemetry::trace::Provider::GetTracerProvider()->GetTracer("ion");
-            auto span = tracer->StartSpan("http_request");
-            auto scope = tracer->WithActiveSpan(span);
-
-            spdlog::debug("received HEADERS frame for stream {}", frame.stream_id());
-            spdlog::debug(" - end headers: {}, end stream: {}, length: {}", frame.is_end_headers(),
-                          frame.is_end_stream(), frame.length());
-
-            log_dynamic_tables();
-            auto hdrs = decoder_.decode(frame.headers_block());
-            if (!hdrs) {
-                update_state(Http2ConnectionState::ProtocolError);
-                return;
-            }
-
-            for (const auto& hdr : *hdrs) {
-                spdlog::debug(" - request header: {}: {}", hdr.name, hdr.value);
-            }
-
-            auto resp = process_request(*hdrs, span);
-            auto hdrs_bytes = encoder_.encode(resp.headers);
-            log_dynamic_tables();
-
-            auto ending_stream = resp.body.empty();
-            write_headers_response(frame.stream_id(), hdrs_bytes,
-                                   FLAG_END_HEADERS | (ending_stream ? FLAG_END_STREAM : 0));
-            spdlog::info(std::format("{} status code sent w/headers", resp.status_code));
-
-            if (!ending_stream) {
-                spdlog::info("sending response body (length: {})", resp.body.size());
-                write_data_response(frame.stream_id(), resp.body);
-            }
-
-            AccessLog::log_request(*hdrs, resp.status_code, resp.body.size(), client_ip_);
+            process_headers_frame(frame);
             break;
         }
         case FRAME_TYPE_WINDOW_UPDATE: {
-            spdlog::debug("received WINDOW_UPDATE frame for stream {}", frame.stream_id());
-            const auto [window_size_increment] = frame.read_window_update();
-            spdlog::debug("window size increment = {}", window_size_increment);
+            process_window_update(frame);
+            break;
+        }
+        case FRAME_TYPE_RST_STREAM: {
+            process_rst_stream(frame);
             break;
         }
         case FRAME_TYPE_GOAWAY: {
-            spdlog::debug("received GOAWAY frame (stream {})", frame.stream_id());
+            SPDLOG_DEBUG("received GOAWAY frame (stream {})", frame.stream_id());
             update_state(Http2ConnectionState::ClientClosed);
             break;
         }
         default:
-            spdlog::debug("received unknown frame type: {}", frame.type());
+            SPDLOG_DEBUG("received unknown frame type: {}", frame.type());
             break;
     }
 }
 
+void Http2Connection::process_settings(const std::vector<Http2Setting>& settings) {
+    for (const auto& setting : settings) {
+        if (setting.identifier == SETTINGS_MAX_FRAME_SIZE) {
+            if (setting.value < DEFAULT_MAX_FRAME_SIZE || setting.value > MAX_MAX_FRAME_SIZE) {
+                spdlog::warn("invalid max frame size ({})", setting.value);
+                fail_connection(ErrorCode::protocol_error);
+                return;
+            }
+            peer_max_frame_size_ = setting.value;
+            continue;
+        }
+        if (setting.identifier != SETTINGS_INITIAL_WINDOW_SIZE) {
+            continue;
+        }
+        if (setting.value > MAX_WINDOW_SIZE) {
+            spdlog::warn("initial window size too big ({})", setting.value);
+            fail_connection(ErrorCode::flow_control_error);
+            return;
+        }
+        // applies to open streams too, by the difference from the previous value
+        const int64_t delta = setting.value - peer_initial_window_size_;
+        peer_initial_window_size_ = setting.value;
+        for (auto& pending : pending_bodies_) {
+            pending.send_window += delta;
+            // a window raised by WINDOW_UPDATE can be pushed past the limit this way too
+            // (RFC 9113 section 6.9.2)
+            if (pending.send_window > MAX_WINDOW_SIZE) {
+                spdlog::warn("flow-control window overflow (stream {})", pending.stream_id);
+                fail_connection(ErrorCode::flow_control_error);
+                return;
+            }
+        }
+        SPDLOG_DEBUG("peer initial window size now {}", peer_initial_window_size_);
+    }
+}
+
+void Http2Connection::process_window_update(const Http2FrameReader& frame) {
+    SPDLOG_DEBUG("received WINDOW_UPDATE frame for stream {}", frame.stream_id());
+    if (frame.length() != Http2WindowUpdate::wire_size) {
+        spdlog::warn("invalid WINDOW_UPDATE frame length: {}", frame.length());
+        fail_connection(ErrorCode::frame_size_error);
+        return;
+    }
+    const auto [window_size_increment] = frame.read_window_update();
+    SPDLOG_DEBUG("window size increment = {}", window_size_increment);
+
+    // errors on a stream's window only end that stream (RFC 9113 section 6.9)
+    const auto fail = [this, &frame](ErrorCode error_code) {
+        if (frame.stream_id() == 0) {
+            fail_connection(error_code);
+        } else {
+            reset_stream(frame.stream_id(), error_code);
+        }
+    };
+    if (window_size_increment == 0) {
+        spdlog::warn("WINDOW_UPDATE with zero increment (stream {})", frame.stream_id());
+        fail(ErrorCode::protocol_error);
+        return;
+    }
+
+    int64_t* window = &connection_send_window_;
+    if (frame.stream_id() != 0) {
+        // only streams still sending bodies are flow controlled
+        const auto it =
+            std::ranges::find(pending_bodies_, frame.stream_id(), &PendingBody::stream_id);
+        if (it == pending_bodies_.end()) {
+            return;
+        }
+        window = &it->send_window;
+    }
+    *window += window_size_increment;
+    if (*window > MAX_WINDOW_SIZE) {
+        spdlog::warn("flow-control window overflow (stream {})", frame.stream_id());
+        fail(ErrorCode::flow_control_error);
+    }
+}
+
+void Http2Connection::process_rst_stream(const Http2FrameReader& frame) {
+    SPDLOG_DEBUG("received RST_STREAM frame for stream {}", frame.stream_id());
+    drop_pending_body(frame.stream_id());
+}
+
+void Http2Connection::fail_connection(ErrorCode error_code) {
+    connection_error_ = error_code;
+    update_state(Http2ConnectionState::ProtocolError);
+}
+
+void Http2Connection::reset_stream(uint32_t stream_id, ErrorCode error_code) {
+    write_rst_stream(stream_id, error_code);
+    drop_pending_body(stream_id);
+}
+
+void Http2Connection::drop_pending_body(uint32_t stream_id) {
+    // frames are only read once the current DATA frame is fully written, so the stream can be
+    // dropped without leaving a partial frame behind
+    const auto erased = std::erase_if(pending_bodies_, [stream_id](const PendingBody& pending) {
+        return pending.stream_id == stream_id;
+    });
+    if (erased != 0) {
+        metrics_.set_active_streams(static_cast<int64_t>(pending_bodies_.size()));
+    }
+}
+
 constexpr std::string_view state_to_string(Http2ConnectionState state) {
     switch (state) {
         case Http2ConnectionState::AwaitingHandshake:
@@ -327,28 +447,34 @@ Http2ProcessResult Http2Connection::process() {
 }
 
 std::optional<Http2ProcessResult> Http2Connection::handle_handshake() {
-    if (auto handshake_result = transport_->handshake()) {
+    return handle_handshake_result(transport_->handshake());
+}
+
+std::optional<Http2ProcessResult> Http2Connection::handle_handshake_result(
+    const std::expected<void, TransportError>& handshake_result) {
+    if (handshake_result) {
         update_last_activity();
-        spdlog::trace("transport handshake complete");
+        metrics_.handshake_complete();
+        SPDLOG_TRACE("transport handshake complete");
         update_state(Http2ConnectionState::AwaitingPreface);
         return std::nullopt;
     } else {
         if (handshake_result.error() == TransportError::WantReadOrWrite) {
-            spdlog::trace("handshake: want read/write");
+            SPDLOG_TRACE("handshake: want read/write");
             return Http2ProcessResult::WantRead;
         }
         if (handshake_result.error() == TransportError::ConnectionClosed) {
-            spdlog::trace("handshake: connection closed");
+            SPDLOG_TRACE("handshake: connection closed");
             return Http2ProcessResult::DiscardConnection;
         }
-        spdlog::trace("handshake: connection error");
+        SPDLOG_TRACE("handshake: connection error");
         return Http2ProcessResult::DiscardConnection;
     }
 }
 
 Http2ProcessResult Http2Connection::internal_process() {
     while (true) {
-        spdlog::trace("processing state: {}", state_to_string(state_));
+        SPDLOG_TRACE("processing state: {}", state_to_string(state_));
 
         if (state_ == Http2ConnectionState::AwaitingHandshake) {
             if (const auto result = handle_handshake()) {
@@ -356,10 +482,10 @@ Http2ProcessResult Http2Connection::internal_process() {
             }
         }
 
-        flush_write_buffer();
+        flush_pending_writes();
 
         // if we still have data to send, we are blocked on writing
-        if (!write_buffer_.empty()) {
+        if (has_pending_writes()) {
             return Http2ProcessResult::WantWrite;
         }
 
@@ -378,13 +504,17 @@ Http2ProcessResult Http2Connection::internal_process() {
             }
             case Http2ConnectionState::AwaitingFrame: {
                 if (try_read_frame()) {
-                    spdlog::debug("frame processed, continuing...");
+                    SPDLOG_DEBUG("frame processed, continuing...");
                     break;
                 }
+                if (has_sendable_body()) {
+                    // nothing to read, so go back to sending the next file DATA frame
+                    continue;
+                }
                 return Http2ProcessResult::WantRead;
             }
             case Http2ConnectionState::Closing: {
-                spdlog::debug("in closing state, completing shutdown");
+                SPDLOG_DEBUG("in closing state, completing shutdown");
                 transport_->graceful_shutdown();
                 update_state(Http2ConnectionState::ClientClosed);
                 return Http2ProcessResult::DiscardConnection;
@@ -392,6 +522,8 @@ Http2ProcessResult Http2Connection::internal_process() {
             case Http2ConnectionState::ProtocolError: {
                 spdlog::error("protocol error. closing connection");
                 close();
+                // best effort, so the peer learns the error code from the GOAWAY
+                flush_write_buffer();
                 return Http2ProcessResult::DiscardConnection;
             }
             case Http2ConnectionState::ClientClosed: {
@@ -404,80 +536,164 @@ Http2ProcessResult Http2Connection::internal_process() {
     }
 }
 
+bool Http2Connection::awaiting_handshake() const {
+    return state_ == Http2ConnectionState::AwaitingHandshake;
+}
+
+const Transport& Http2Connection::transport() const {
+    return *transport_;
+}
+
+Http2ProcessResult Http2Connection::complete_handshake(
+    const std::expected<void, TransportError>& result) {
+    if (const auto process_result = handle_handshake_result(result)) {
+        return *process_result;
+    }
+    return process();
+}
+
 void Http2Connection::close() {
     if (state_ == Http2ConnectionState::Closing) {
         spdlog::error("attempting to close connection in closing state");
         return;
     }
     write_goaway(1, (state_ != Http2ConnectionState::ProtocolError) ? ErrorCode::no_error
-                                                                    : ErrorCode::protocol_error);
-    spdlog::debug("GOAWAY frame enqueued");
+                                                                    : connection_error_);
+    SPDLOG_DEBUG("GOAWAY frame enqueued");
     update_state(Http2ConnectionState::Closing);
 }
 
 void Http2Connection::update_state(Http2ConnectionState new_state) {
     if (new_state != state_) {
-        spdlog::debug("connection state changed from {} to {}", state_to_string(state_),
-                      state_to_string(new_state));
+        SPDLOG_DEBUG("connection state changed from {} to {}", state_to_string(state_),
+                     state_to_string(new_state));
         state_ = new_state;
     }
 }
 
 void Http2Connection::log_dynamic_tables() {
-    spdlog::debug("decoder dynamic table:");
+    // runs twice per request, so don't walk the tables unless they'll be logged
+    if (SPDLOG_ACTIVE_LEVEL > SPDLOG_LEVEL_DEBUG || !spdlog::should_log(spdlog::level::debug)) {
+        return;
+    }
+    SPDLOG_DEBUG("decoder dynamic table:");
     decoder_dynamic_table_.log_contents();
-    spdlog::debug("encoder dynamic table:");
+    SPDLOG_DEBUG("encoder dynamic table:");
     encoder_dynamic_table_.log_contents();
 }
 
-static std::optional<std::string> get_header(const std::vector<HttpHeader>& headers,
-                                             const std::string& name) {
-    const auto it = std::find_if(headers.begin(), headers.end(),
-                                 [name](const HttpHeader& hdr) { return hdr.name == name; });
-    if (it == headers.end()) {
-        return std::nullopt;
+void Http2Connection::process_headers_frame(const Http2FrameReader& frame) {
+    log_dynamic_tables();
+    RequestPseudoHeaders pseudo{};
+    auto hdrs = decoder_.decode(frame.headers_block(), pseudo);
+    if (!hdrs) {
+        update_state(Http2ConnectionState::ProtocolError);
+        return;
+    }
+
+    HttpRequest req{.method = pseudo.method,
+                    .path = std::move(pseudo.path),
+                    .headers = std::move(*hdrs),
+                    .scheme = std::move(pseudo.scheme),
+                    .authority = std::move(pseudo.authority),
+                    .method_name = std::move(pseudo.method_name)};
+
+    // requests continuing a trace follow the caller's sampling decision
+    const auto parent = TraceParent::extract(req.headers);
+    if (parent ? parent->sampled : sampler_.sample()) {
+        opentelemetry::trace::StartSpanOptions options{};
+        options.kind = opentelemetry::trace::SpanKind::kServer;
+        if (parent) {
+            options.parent = parent->context;
+        }
+        auto& tracer = request_tracer();
+        auto span = tracer.StartSpan("http_request", options);
+        auto scope = tracer.WithActiveSpan(span);
+        respond(frame, req, span.get());
+    } else {
+        respond(frame, req, nullptr);
     }
-    return it->value;
 }
 
-HttpResponse Http2Connection::process_request(const std::vector<HttpHeader>& headers,
-                                              SpanPtr span) {
-    auto path = get_header(headers, ":path");
-    auto method = get_header(headers, ":method");
+void Http2Connection::respond(const Http2FrameReader& frame, HttpRequest& req,
+                              opentelemetry::trace::Span* span) {
+    SPDLOG_DEBUG("received HEADERS frame for stream {}", frame.stream_id());
+    SPDLOG_DEBUG(" - end headers: {}, end stream: {}, length: {}", frame.is_end_headers(),
+                 frame.is_end_stream(), frame.length());
+    SPDLOG_DEBUG(" - request: {} {}", req.method_name, req.path);
+    for ([[maybe_unused]] const auto& hdr : req.headers) {
+        SPDLOG_DEBUG(" - request header: {}: {}", hdr.name, hdr.value);
+    }
 
-    if (!path || !method) {
+    // bodies still being sent keep their streams open
+    metrics_.set_active_streams(static_cast<int64_t>(pending_bodies_.size()) + 1);
+    const auto start = std::chrono::steady_clock::now();
+    auto resp = process_request(req, span);
+    auto hdrs_bytes =
+        encoder_.encode(resp.headers, {resp.pre_encoded_headers.get(), &SERVER_HEADERS,
+                                       date_header(resp)});
+    log_dynamic_tables();
+    metrics_.set_hpack_table_sizes(decoder_dynamic_table_.size(), encoder_dynamic_table_.size());
+
+    const auto body_size = resp.body_size();
+    auto ending_stream = body_size == 0;
+    write_headers_response(frame.stream_id(), hdrs_bytes,
+                           FLAG_END_HEADERS | (ending_stream ? FLAG_END_STREAM : 0));
+    SPDLOG_DEBUG("{} status code sent w/headers", resp.status_code);
+
+    if (!ending_stream) {
+        // sent as the peer's flow-control windows allow, taking turns with other streams
+        SPDLOG_DEBUG("sending response body (length: {})", body_size);
+        pending_bodies_.push_back({.stream_id = frame.stream_id(),
+                                   .file = std::move(resp.file_body),
+                                   .body = std::move(resp.body),
+                                   .shared_body = std::move(resp.shared_body),
+                                   .send_window = peer_initial_window_size_});
+    }
+
+    metrics_.set_active_streams(static_cast<int64_t>(pending_bodies_.size()));
+    ServerMetrics::record_request(req.route, resp.status_code,
+                                  std::chrono::steady_clock::now() - start);
+    AccessLog::log_request(req, resp.status_code, body_size, client_ip_);
+}
+
+HttpResponse Http2Connection::process_request(HttpRequest& req,
+                                              opentelemetry::trace::Span* span) {
+    if (req.method_name.empty() || req.path.empty()) {
         spdlog::error("invalid request: missing path or method");
         return HttpResponse{.status_code = 400};
     }
 
-    span->SetAttribute("http.method", *method);
-    span->SetAttribute("http.target", *path);
-    span->SetAttribute("ion.client_ip", client_ip_);
-
-    auto handler = router_.get_handler(path.value(), method.value());
-    HttpRequest req{.method = *method, .path = *path, .headers = headers};
+    if (span) {
+        span->SetAttribute("http.method", attribute_view(req.method_name));
+        span->SetAttribute("http.target", attribute_view(req.path));
+        span->SetAttribute("ion.client_ip", attribute_view(client_ip_));
+    }
 
     HttpResponse resp;
     try {
-        resp = handler(req);
+        resp = dispatcher_.dispatch(req);
     } catch (const std::exception& e) {
         spdlog::error("error processing request: {}", e.what());
         resp = HttpResponse{.status_code = 500};
     }
 
-    span->SetAttribute("http.status_code", resp.status_code);
+    if (span) {
+        span->SetAttribute("http.status_code", resp.status_code);
+    }
 
     resp.headers.insert(resp.headers.begin(),
                         HttpHeader{":status", std::to_string(resp.status_code)});
-    if (!resp.body.empty()) {
-        resp.headers.push_back({"content-length", std::to_string(resp.body.size())});
+    if (const auto body_size = resp.body_size(); body_size != 0) {
+        resp.headers.push_back({"content-length", std::to_string(body_size)});
     }
-    resp.headers.push_back({"server", std::string{SERVER_HEADER}});
-    resp.headers.push_back({"x-powered-by", std::string{SERVER_HEADER}});
     return resp;
 }
 
 void Http2Connection::enqueue_write(std::span<const uint8_t> data) {
+    if (write_buffer_.capacity() == 0) {
+        write_buffer_ = BufferPool::local().acquire();
+    }
     write_buffer_.insert(write_buffer_.end(), data.begin(), data.end());
 }
 
@@ -494,7 +710,7 @@ void Http2Connection::flush_write_buffer() {
         if (result.error() == TransportError::WantReadOrWrite) {
             // do nothing. The buffer remains intact for the next attempt.
             // SSL_write requirement: address and size stay the same.
-            spdlog::trace("transport busy, write will be resumed later");
+            SPDLOG_TRACE("transport busy, write will be resumed later");
         } else {
             spdlog::error("failed to flush write buffer: error: {}",
                           static_cast<int>(result.error()));
@@ -503,18 +719,174 @@ void Http2Connection::flush_write_buffer() {
         return;
     }
     update_last_activity();
-    spdlog::trace("flushed {} bytes from write buffer", *result);
+    metrics_.add_sent(static_cast<uint64_t>(*result));
+    SPDLOG_TRACE("flushed {} bytes from write buffer", *result);
 
     // remove what was actually sent
     write_buffer_.erase(write_buffer_.begin(), write_buffer_.begin() + *result);
+    if (write_buffer_.empty()) {
+        BufferPool::local().release(write_buffer_);
+    }
+}
+
+void Http2Connection::flush_pending_writes() {
+    // starts at most one DATA frame per call, so frames from the peer (WINDOW_UPDATE,
+    // RST_STREAM, new requests...) are read and handled in between
+    bool frame_started = false;
+    while (true) {
+        if (!write_buffer_.empty()) {
+            flush_write_buffer();
+            if (!write_buffer_.empty()) {
+                return;
+            }
+        }
+        if (file_frame_remaining_ != 0) {
+            send_file_frame_payload();
+            if (file_frame_remaining_ != 0) {
+                return;
+            }
+            continue;
+        }
+        if (frame_started || state_ == Http2ConnectionState::ProtocolError ||
+            !has_sendable_body()) {
+            return;
+        }
+        start_data_frame();
+        frame_started = true;
+    }
+}
+
+bool Http2Connection::has_pending_writes() const {
+    return !write_buffer_.empty() || file_frame_remaining_ != 0;
+}
+
+bool Http2Connection::has_sendable_body() const {
+    return connection_send_window_ > 0 &&
+           std::ranges::any_of(pending_bodies_, [](const PendingBody& pending) {
+               return pending.send_window > 0;
+           });
+}
+
+void Http2Connection::start_data_frame() {
+    // the first stream the peer's window allows goes to the front, where it stays until the
+    // frame is written
+    const auto next = std::ranges::find_if(
+        pending_bodies_, [](const PendingBody& pending) { return pending.send_window > 0; });
+    std::rotate(pending_bodies_.begin(), next, next + 1);
+
+    auto& pending = pending_bodies_.front();
+    const auto window = static_cast<size_t>(std::min(pending.send_window, connection_send_window_));
+    const size_t chunk_size = std::min({pending.length() - pending.sent, window,
+                                        size_t{peer_max_frame_size_}, MAX_DATA_FRAME_SIZE});
+    const bool last_frame = pending.sent + chunk_size == pending.length();
+    pending.send_window -= static_cast<int64_t>(chunk_size);
+    connection_send_window_ -= static_cast<int64_t>(chunk_size);
+
+    write_frame_header({.length = static_cast<uint32_t>(chunk_size),
+                        .type = FRAME_TYPE_DATA,
+                        .flags = last_frame ? FLAG_END_STREAM : static_cast<uint8_t>(0),
+                        .stream_id = pending.stream_id});
+
+    if (!pending.file) {
+        enqueue_write(pending.memory().subspan(pending.sent, chunk_size));
+        SPDLOG_TRACE("enqueued data frame (size: {}, stream: {})", chunk_size, pending.stream_id);
+        pending.sent += chunk_size;
+        end_data_frame();
+        return;
+    }
+
+    const auto& file = *pending.file;
+    if (transport_->supports_send_file()) {
+        // the header is flushed first, then the payload goes straight from the page cache
+        file_frame_remaining_ = chunk_size;
+        return;
+    }
+
+    const auto start = write_buffer_.size();
+    write_buffer_.resize(start + chunk_size);
+    const auto bytes_read = ::pread(file.fd(), write_buffer_.data() + start, chunk_size,
+                                    static_cast<off_t>(file.offset() + pending.sent));
+    if (bytes_read != static_cast<ssize_t>(chunk_size)) {
+        write_buffer_.resize(start - Http2FrameHeader::wire_size);
+        abort_pending_bodies("failed to read file body");
+        return;
+    }
+    SPDLOG_TRACE("enqueued file data frame (size: {}, stream: {})", chunk_size, pending.stream_id);
+    pending.sent += chunk_size;
+    end_data_frame();
+}
+
+void Http2Connection::end_data_frame() {
+    if (pending_bodies_.front().sent == pending_bodies_.front().length()) {
+        pending_bodies_.erase(pending_bodies_.begin());
+        metrics_.set_active_streams(static_cast<int64_t>(pending_bodies_.size()));
+        return;
+    }
+    // round robin, so one large file doesn't hold up the others
+    std::rotate(pending_bodies_.begin(), pending_bodies_.begin() + 1, pending_bodies_.end());
+}
+
+void Http2Connection::send_file_frame_payload() {
+    auto& pending = pending_bodies_.front();
+    const auto& file = *pending.file;
+    const auto result = transport_->send_file(
+        file.fd(), static_cast<off_t>(file.offset() + pending.sent), file_frame_remaining_);
+    if (!result) {
+        if (result.error() == TransportError::WantReadOrWrite) {
+            SPDLOG_TRACE("transport busy, file send will be resumed later");
+        } else {
+            abort_pending_bodies("failed to send file body");
+        }
+        return;
+    }
+    if (*result == 0) {
+        // the file shrank after the response was built
+        abort_pending_bodies("file body ended early");
+        return;
+    }
+    update_last_activity();
+    metrics_.add_sent(static_cast<uint64_t>(*result));
+    SPDLOG_TRACE("sent {} bytes of file body (stream: {})", *result, pending.stream_id);
+
+    pending.sent += *result;
+    file_frame_remaining_ -= *result;
+    if (file_frame_remaining_ == 0) {
+        end_data_frame();
+    }
+}
+
+void Http2Connection::abort_pending_bodies(std::string_view reason) {
+    spdlog::error("{}, closing connection", reason);
+    pending_bodies_.clear();
+    metrics_.set_active_streams(0);
+    if (file_frame_remaining_ != 0) {
+        // a DATA frame is partially written, so not even a GOAWAY can follow it
+        file_frame_remaining_ = 0;
+        update_state(Http2ConnectionState::ClientClosed);
+        return;
+    }
+    update_state(Http2ConnectionState::ProtocolError);
 }
 
 void Http2Connection::update_last_activity() {
     last_activity_ = std::chrono::steady_clock::now();
 }
 
+size_t Http2Connection::memory_usage() const {
+    size_t pending_bytes = pending_bodies_.capacity() * sizeof(PendingBody);
+    for (const auto& pending : pending_bodies_) {
+        pending_bytes += pending.body.capacity();
+    }
+    return sizeof(*this) + client_ip_.capacity() + read_buffer_.capacity() +
+           write_buffer_.capacity() + pending_bytes +
+           static_cast<size_t>(decoder_dynamic_table_.size() + encoder_dynamic_table_.size());
+}
+
 bool Http2Connection::has_timed_out() const {
-    return (std::chrono::steady_clock::now() - last_activity_) > IDLE_TIMEOUT;
+    // bodies left to send mean the connection is waiting on the peer's flow-control windows
+    // (or on the transport), not idle
+    const auto timeout = pending_bodies_.empty() ? IDLE_TIMEOUT : FLOW_CONTROL_STALL_TIMEOUT;
+    return (std::chrono::steady_clock::now() - last_activity_) > timeout;
 }
 
 }  // namespace ion
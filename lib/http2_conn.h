@@ -9,13 +9,13 @@
 #include "hpack/header_block_encoder.h"
 #include "http2_frame_reader.h"
 #include "http2_frames.h"
-#include "router.h"
+#include "request_dispatcher.h"
+#include "request_sampler.h"
+#include "server_metrics.h"
 #include "transports/transport.h"
 
 namespace ion {
 
-using SpanPtr = opentelemetry::nostd::shared_ptr<opentelemetry::trace::Span>;
-
 enum class Http2ProcessResult {
     WantRead,
     WantWrite,
@@ -33,10 +33,35 @@ enum class Http2ConnectionState {
 
 enum class ReadPrefaceResult { Success, NotEnoughData, ProtocolError };
 
+// A response body still to be sent as DATA frames: a file, or else an in-memory body held in
+// body or shared_body.
+struct PendingBody {
+    uint32_t stream_id;
+    std::shared_ptr<const FileBody> file{};
+    std::vector<uint8_t> body{};
+    std::shared_ptr<const std::vector<uint8_t>> shared_body{};
+    // bytes of the body already framed (or sent, for the frame in progress)
+    size_t sent{};
+    // the peer's flow-control window for the stream; may go negative if the peer shrinks
+    // SETTINGS_INITIAL_WINDOW_SIZE
+    int64_t send_window{};
+
+    [[nodiscard]] std::span<const uint8_t> memory() const {
+        return shared_body ? std::span<const uint8_t>{*shared_body} : std::span{body};
+    }
+
+    [[nodiscard]] size_t length() const {
+        return file ? file->length() : memory().size();
+    }
+};
+
 class Http2Connection {
    public:
-    explicit Http2Connection(std::unique_ptr<Transport> transport, const std::string& client_ip,
-                             const Router& router);
+    explicit Http2Connection(
+        std::unique_ptr<Transport> transport, const std::string& client_ip,
+        const RequestDispatcher& dispatcher,
+        const IndexingPolicyConfig& indexing_config = DEFAULT_INDEXING_POLICY_CONFIG,
+        const RequestSampler& sampler = ALWAYS_SAMPLE);
     Http2Connection(const Http2Connection&) = delete;
     Http2Connection& operator=(const Http2Connection&) = delete;
     Http2Connection(Http2Connection&&) = delete;
@@ -45,19 +70,46 @@ class Http2Connection {
     Http2ProcessResult process();
     void close();
     [[nodiscard]] bool has_timed_out() const;
+    // approximate bytes held by the connection, excluding the transport (e.g. OpenSSL state)
+    [[nodiscard]] size_t memory_usage() const;
+
+    // for running the handshake elsewhere (see HandshakePool): transport() may be handed to
+    // another thread while awaiting_handshake(), and the result passed back to
+    // complete_handshake() on the event loop, which then continues processing
+    [[nodiscard]] bool awaiting_handshake() const;
+    [[nodiscard]] const Transport& transport() const;
+    Http2ProcessResult complete_handshake(const std::expected<void, TransportError>& result);
 
    private:
+    static constexpr int64_t DEFAULT_WINDOW_SIZE = 65535;
+    static constexpr uint32_t DEFAULT_MAX_FRAME_SIZE = 16384;
+
     std::unique_ptr<Transport> transport_;
     std::string client_ip_;
-    const Router& router_;
+    const RequestDispatcher& dispatcher_;
+    const RequestSampler& sampler_;
+    // both buffers come from BufferPool::local() when data arrives or is queued and go back
+    // once drained, so idle connections hold no buffer memory
     std::vector<uint8_t> read_buffer_;
     std::vector<uint8_t> write_buffer_;
+    // response bodies are framed one DATA frame at a time once write_buffer_ has drained, so
+    // memory use doesn't grow with file size. Incoming frames are handled between DATA frames,
+    // which are only sent while the peer's flow-control windows allow it
+    std::vector<PendingBody> pending_bodies_{};
+    // payload bytes of the current DATA frame still to be passed to Transport::send_file
+    size_t file_frame_remaining_{};
+    int64_t connection_send_window_{DEFAULT_WINDOW_SIZE};
+    int64_t peer_initial_window_size_{DEFAULT_WINDOW_SIZE};
+    uint32_t peer_max_frame_size_{DEFAULT_MAX_FRAME_SIZE};
+    // sent in the GOAWAY when the connection closes in ProtocolError
+    ErrorCode connection_error_{ErrorCode::protocol_error};
     Http2ConnectionState state_ = Http2ConnectionState::AwaitingHandshake;
     DynamicTable decoder_dynamic_table_{};
     DynamicTable encoder_dynamic_table_{};
     HeaderBlockDecoder decoder_{decoder_dynamic_table_};
-    HeaderBlockEncoder encoder_{encoder_dynamic_table_};
+    HeaderBlockEncoder encoder_;
     std::chrono::steady_clock::time_point last_activity_{std::chrono::steady_clock::now()};
+    ConnectionMetrics metrics_{};
 
     Http2ProcessResult internal_process();
     ReadPrefaceResult read_preface();
@@ -70,17 +122,36 @@ class Http2Connection {
     void write_settings_ack();
     void write_headers_response(uint32_t stream_id, std::span<const uint8_t> headers_data,
                                 uint8_t flags);
-    void write_data_response(uint32_t uint32, const std::vector<uint8_t>& body);
     void write_goaway(uint32_t last_stream_id, ErrorCode error_code);
+    void write_rst_stream(uint32_t stream_id, ErrorCode error_code);
     void write_settings();
     void process_frame(const Http2FrameReader& frame);
+    void process_settings(const std::vector<Http2Setting>& settings);
+    void process_window_update(const Http2FrameReader& frame);
+    void process_rst_stream(const Http2FrameReader& frame);
+    void fail_connection(ErrorCode error_code);
+    void reset_stream(uint32_t stream_id, ErrorCode error_code);
+    void drop_pending_body(uint32_t stream_id);
     void update_state(Http2ConnectionState new_state);
     void log_dynamic_tables();
-    HttpResponse process_request(const std::vector<HttpHeader>& req_hdrs, SpanPtr span);
+    void process_headers_frame(const Http2FrameReader& frame);
+    void respond(const Http2FrameReader& frame, HttpRequest& req,
+                 opentelemetry::trace::Span* span);
+    // span is null when the request isn't sampled
+    HttpResponse process_request(HttpRequest& req, opentelemetry::trace::Span* span);
     void enqueue_write(std::span<const uint8_t> data);
     void flush_write_buffer();
+    void flush_pending_writes();
+    [[nodiscard]] bool has_pending_writes() const;
+    [[nodiscard]] bool has_sendable_body() const;
+    void start_data_frame();
+    void end_data_frame();
+    void send_file_frame_payload();
+    void abort_pending_bodies(std::string_view reason);
     void update_last_activity();
     std::optional<Http2ProcessResult> handle_handshake();
+    std::optional<Http2ProcessResult> handle_handshake_result(
+        const std::expected<void, TransportError>& result);
 };
 
 }  // namespace ion
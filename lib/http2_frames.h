@@ -113,6 +113,25 @@ struct Http2WindowUpdate {
     }
 };
 
-enum class ErrorCode : uint32_t { no_error = 0x00, protocol_error = 0x01 };
+struct Http2RstStream {
+    uint32_t error_code;
+
+    static constexpr size_t wire_size = 4;
+
+    static Http2RstStream parse(std::span<const uint8_t, wire_size> data) {
+        return Http2RstStream{.error_code = load_uint32_be(data)};
+    }
+
+    void serialize(std::span<uint8_t, wire_size> data) const {
+        store_uint32_be(error_code, data);
+    }
+};
+
+enum class ErrorCode : uint32_t {
+    no_error = 0x00,
+    protocol_error = 0x01,
+    flow_control_error = 0x03,
+    frame_size_error = 0x06
+};
 
 }  // namespace ion
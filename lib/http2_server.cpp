@@ -3,6 +3,7 @@
 #include <spdlog/spdlog.h>
 
 #include <optional>
+#include <ranges>
 #include <set>
 
 #include "pollers/poll_poller.h"
@@ -16,10 +17,11 @@ namespace ion {
 static constexpr std::size_t MAX_CONNECTIONS = 128;
 static constexpr std::chrono::milliseconds POLL_TIMEOUT{25};
 
-Http2Server::Http2Server(const ServerConfiguration& config) : router_(Router{}), config_(config) {
+Http2Server::Http2Server(const ServerConfiguration& config)
+    : router_(Router{}), config_(config), request_sampler_(config.trace_sample_ratio) {
     config_.validate();
     if (!config_.cleartext) {
-        tls_ctx_.emplace(*config_.cert_path, *config_.key_path);
+        tls_ctx_.emplace(*config_.cert_path, *config_.key_path, config_.tls);
     }
 }
 
@@ -30,13 +32,21 @@ std::unique_ptr<Transport> Http2Server::create_transport(SocketFd&& fd) const {
     return std::make_unique<TlsTransport>(std::move(fd), *tls_ctx_);
 }
 
+ConnectionMemoryStats Http2Server::connection_memory_stats() const {
+    ConnectionMemoryStats stats{.connections = connections_.size(), .total_bytes = 0};
+    for (const auto& conn : connections_ | std::views::values) {
+        stats.total_bytes += conn->memory_usage();
+    }
+    return stats;
+}
+
 void Http2Server::establish_conn(TcpListener& listener, Poller& poller) {
     auto fd = listener.try_accept();
     if (!fd) {
         return;
     }
     const auto client_ip_res = fd->client_ip();
-    spdlog::info("client connected (ip: {})", client_ip_res.value_or("unknown"));
+    SPDLOG_DEBUG("client connected (ip: {})", client_ip_res.value_or("unknown"));
 
     const int raw_fd = *fd;
     auto transport = create_transport(std::move(fd.value()));
@@ -44,10 +54,12 @@ void Http2Server::establish_conn(TcpListener& listener, Poller& poller) {
         return;
     }
 
+    const RequestDispatcher& dispatcher = dispatcher_ ? *dispatcher_ : router_;
     auto conn = std::make_unique<Http2Connection>(std::move(transport), client_ip_res.value_or(""),
-                                                  router_);
+                                                  dispatcher, config_.hpack_indexing,
+                                                  request_sampler_);
     connections_[raw_fd] = std::move(conn);
-    spdlog::info("HTTP connection established. total = {}", connections_.size());
+    SPDLOG_DEBUG("HTTP connection established. total = {}", connections_.size());
 
     poller.set(raw_fd, PollEventType::Read);
 }
@@ -55,7 +67,7 @@ void Http2Server::establish_conn(TcpListener& listener, Poller& poller) {
 void Http2Server::reap_idle_connections(Poller& poller) {
     for (auto it = connections_.begin(); it != connections_.end();) {
         const auto& conn = it->second;
-        if (conn->has_timed_out()) {
+        if (!handshakes_in_flight_.contains(it->first) && conn->has_timed_out()) {
             spdlog::warn("closing connection due to inactivity (fd: {})", it->first);
             poller.remove(it->first);
             it = connections_.erase(it);
@@ -84,7 +96,7 @@ void Http2Server::handle_connection_events(Poller& poller, int fd, PollEventType
     }
     if (has_event(poll_events, PollEventType::Error) ||
         has_event(poll_events, PollEventType::Hangup)) {
-        spdlog::debug("poll indicated connection closed");
+        SPDLOG_DEBUG("poll indicated connection closed");
         connections_.erase(it);
         poller.remove(fd);
         return;
@@ -101,22 +113,49 @@ void Http2Server::handle_connection_events(Poller& poller, int fd, PollEventType
     }
 
     const auto& conn = it->second;
-    switch (conn->process()) {
+    if (handshake_pool_ && conn->awaiting_handshake()) {
+        start_handshake(poller, fd, *conn);
+        return;
+    }
+    handle_process_result(poller, fd, conn->process());
+}
+
+void Http2Server::handle_process_result(Poller& poller, int fd, Http2ProcessResult result) {
+    switch (result) {
         case Http2ProcessResult::WantWrite:
-            spdlog::trace("will poll write events for fd {}", fd);
+            SPDLOG_TRACE("will poll write events for fd {}", fd);
             poller.set(fd, PollEventType::Read | PollEventType::Write);
             break;
         case Http2ProcessResult::WantRead:
             // interest is already Read (or was reset above), just keep waiting
             break;
         case Http2ProcessResult::DiscardConnection:
-            spdlog::info("closing connection");
+            SPDLOG_DEBUG("closing connection");
             poller.remove(fd);
-            connections_.erase(it);
+            connections_.erase(fd);
             break;
     }
 }
 
+void Http2Server::start_handshake(Poller& poller, int fd, const Http2Connection& conn) {
+    // stop polling until the worker is done so no other event touches the connection
+    poller.remove(fd);
+    handshakes_in_flight_.insert(fd);
+    handshake_pool_->submit(fd, conn.transport());
+}
+
+void Http2Server::complete_handshakes(Poller& poller) {
+    for (const auto& [fd, result] : handshake_pool_->drain()) {
+        handshakes_in_flight_.erase(fd);
+        const auto it = connections_.find(fd);
+        if (it == connections_.end()) {
+            continue;
+        }
+        poller.set(fd, PollEventType::Read);
+        handle_process_result(poller, fd, it->second->complete_handshake(result));
+    }
+}
+
 void Http2Server::start(uint16_t port) {
     TcpListener listener{port};
     listener.listen();
@@ -126,6 +165,11 @@ void Http2Server::start(uint16_t port) {
     const auto poller = Poller::create();
     poller->set(listener_fd, PollEventType::Read);
 
+    if (tls_ctx_ && config_.handshake_threads > 0) {
+        handshake_pool_ = std::make_unique<HandshakePool>(config_.handshake_threads);
+        poller->set(handshake_pool_->wake_fd(), PollEventType::Read);
+    }
+
     while (!user_req_termination_) {
         reap_idle_connections(*poller);
 
@@ -136,12 +180,16 @@ void Http2Server::start(uint16_t port) {
         for (auto& [fd, poll_events] : *events) {
             if (fd == listener_fd) {
                 handle_incoming_connection(listener, *poller);
+            } else if (handshake_pool_ && fd == handshake_pool_->wake_fd()) {
+                complete_handshakes(*poller);
             } else {
                 handle_connection_events(*poller, fd, poll_events);
             }
         }
     }
 
+    handshake_pool_.reset();
+    handshakes_in_flight_.clear();
     spdlog::info("server shutting down (reason: {})", StopReasonHelper::to_string(stop_reason_));
 }
 
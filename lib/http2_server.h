@@ -2,7 +2,9 @@
 
 #include <csignal>
 #include <map>
+#include <set>
 
+#include "handshake_pool.h"
 #include "http2_conn.h"
 #include "pollers/poller.h"
 #include "router.h"
@@ -14,6 +16,11 @@
 namespace ion {
 class Poller;
 
+struct ConnectionMemoryStats {
+    size_t connections;
+    size_t total_bytes;
+};
+
 class Http2Server {
    public:
     void start(uint16_t port);
@@ -25,19 +32,45 @@ class Http2Server {
         return router_;
     }
 
+    // Serve requests through another dispatcher (e.g. a CompiledRouteTable) instead of router().
+    // The dispatcher must outlive the server.
+    void set_dispatcher(const RequestDispatcher& dispatcher) {
+        dispatcher_ = &dispatcher;
+    }
+
+    // nullopt when serving cleartext
+    [[nodiscard]] std::optional<TlsHandshakeStats> tls_handshake_stats() const {
+        if (!tls_ctx_) {
+            return std::nullopt;
+        }
+        return tls_ctx_->handshake_stats();
+    }
+
+    // must be called from the event loop thread (e.g. a route handler)
+    [[nodiscard]] ConnectionMemoryStats connection_memory_stats() const;
+
    private:
     void establish_conn(TcpListener& listener, Poller& poller);
     void reap_idle_connections(Poller& poller);
     void handle_incoming_connection(TcpListener& listener, Poller& poller);
     void handle_connection_events(Poller& poller, int fd, PollEventType poll_events);
+    void handle_process_result(Poller& poller, int fd, Http2ProcessResult result);
+    void start_handshake(Poller& poller, int fd, const Http2Connection& conn);
+    void complete_handshakes(Poller& poller);
     std::unique_ptr<Transport> create_transport(SocketFd&& fd) const;
 
     volatile std::sig_atomic_t user_req_termination_ = 0;
     Router router_{};
+    const RequestDispatcher* dispatcher_{};
     ServerConfiguration config_;
+    RequestSampler request_sampler_;
     StopReason stop_reason_{};
     std::map<int, std::unique_ptr<Http2Connection>> connections_;
     std::optional<TlsContext> tls_ctx_{};
+    // declared after connections_ so workers are joined before the transports they use go away
+    std::unique_ptr<HandshakePool> handshake_pool_{};
+    // connections whose handshake is running on the pool; the event loop leaves them alone
+    std::set<int> handshakes_in_flight_{};
 };
 
 }  // namespace ion
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+namespace ion {
+
+enum class HttpMethod : uint8_t { Get, Head, Post, Put, Delete, Patch, Options, Connect, Trace, Other };
+
+class HttpMethodHelper {
+   public:
+    // methods outside the standard set map to Other; their name is kept alongside
+    static constexpr HttpMethod from_string(std::string_view name) {
+        switch (name.size()) {
+            case 3:
+                return name == "GET" ? HttpMethod::Get
+                       : name == "PUT" ? HttpMethod::Put
+                                       : HttpMethod::Other;
+            case 4:
+                return name == "HEAD" ? HttpMethod::Head
+                       : name == "POST" ? HttpMethod::Post
+                                        : HttpMethod::Other;
+            case 5:
+                return name == "PATCH" ? HttpMethod::Patch
+                       : name == "TRACE" ? HttpMethod::Trace
+                                         : HttpMethod::Other;
+            case 6:
+                return name == "DELETE" ? HttpMethod::Delete : HttpMethod::Other;
+            case 7:
+                return name == "OPTIONS" ? HttpMethod::Options
+                       : name == "CONNECT" ? HttpMethod::Connect
+                                           : HttpMethod::Other;
+            default:
+                return HttpMethod::Other;
+        }
+    }
+
+    static constexpr std::string_view to_string(HttpMethod method) {
+        switch (method) {
+            case HttpMethod::Get:
+                return "GET";
+            case HttpMethod::Head:
+                return "HEAD";
+            case HttpMethod::Post:
+                return "POST";
+            case HttpMethod::Put:
+                return "PUT";
+            case HttpMethod::Delete:
+                return "DELETE";
+            case HttpMethod::Patch:
+                return "PATCH";
+            case HttpMethod::Options:
+                return "OPTIONS";
+            case HttpMethod::Connect:
+                return "CONNECT";
+            case HttpMethod::Trace:
+                return "TRACE";
+            default:
+                return "";
+        }
+    }
+};
+
+}  // namespace ion
@@ -1,8 +1,16 @@
 #pragma once
 #include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include "file_body.h"
 #include "hpack/http_header.h"
+#include "hpack/pre_encoded_headers.h"
+#include "http_method.h"
 
 namespace ion {
 
@@ -10,12 +18,58 @@ struct HttpResponse {
     uint16_t status_code;
     std::vector<uint8_t> body{};
     std::vector<HttpHeader> headers{};
+    std::shared_ptr<const PreEncodedHeaders> pre_encoded_headers{};
+    // sent instead of body when set, so one immutable buffer can back many responses
+    std::shared_ptr<const std::vector<uint8_t>> shared_body{};
+    // sent instead of body or shared_body when set
+    std::shared_ptr<const FileBody> file_body{};
+
+    // the in-memory body, whichever of body and shared_body holds it
+    [[nodiscard]] std::span<const uint8_t> memory_body() const {
+        return shared_body ? std::span<const uint8_t>{*shared_body} : std::span{body};
+    }
+
+    [[nodiscard]] size_t body_size() const {
+        return file_body ? file_body->length() : memory_body().size();
+    }
+};
+
+struct RouteParam {
+    std::string name;
+    std::string value;
 };
 
 struct HttpRequest {
-    std::string method;
+    // Other with an empty method_name until a method is set, so a request without one can't
+    // pass for a GET
+    HttpMethod method{HttpMethod::Other};
     std::string path;
+    // regular fields only; :method, :path, :scheme and :authority are carried in the typed
+    // members and are not in this list
     std::vector<HttpHeader> headers{};
+    // values captured by ":name" and "*name" route segments
+    std::vector<RouteParam> params{};
+    // pattern of the route that matched (e.g. "/users/:id"), set by the dispatcher; keeps metrics
+    // and traces low-cardinality. Points into the dispatcher, empty if no route matched
+    std::string_view route{};
+    std::string scheme{};
+    std::string authority{};
+    // as received, needed for HttpMethod::Other
+    std::string method_name{};
+
+    [[nodiscard]] std::string_view method_string() const {
+        return method == HttpMethod::Other ? std::string_view{method_name}
+                                           : HttpMethodHelper::to_string(method);
+    }
+
+    [[nodiscard]] std::optional<std::string_view> param(std::string_view name) const {
+        for (const auto& p : params) {
+            if (p.name == name) {
+                return p.value;
+            }
+        }
+        return std::nullopt;
+    }
 };
 
 }  // namespace ion
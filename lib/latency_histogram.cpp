@@ -0,0 +1,49 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ion {
+
+uint64_t LatencyHistogramSnapshot::count() const {
+    return count_;
+}
+
+uint64_t LatencyHistogramSnapshot::sum() const {
+    return sum_;
+}
+
+uint64_t LatencyHistogramSnapshot::value_at_quantile(double quantile) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    const auto rank = std::max<uint64_t>(
+        1, static_cast<uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * count_)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets_.size(); i++) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            return LatencyBuckets::upper_bound(i);
+        }
+    }
+    return LatencyBuckets::MAX_VALUE;
+}
+
+uint64_t LatencyHistogramSnapshot::count_at_or_below(uint64_t value) const {
+    const auto last = LatencyBuckets::index_of(value);
+    uint64_t total = 0;
+    for (size_t i = 0; i <= last; i++) {
+        total += buckets_[i];
+    }
+    return total;
+}
+
+void LatencyHistogram::merge_into(LatencyHistogramSnapshot& snapshot) const {
+    for (size_t i = 0; i < buckets_.size(); i++) {
+        snapshot.buckets_[i] += buckets_[i].load(std::memory_order_relaxed);
+    }
+    snapshot.count_ += count_.load(std::memory_order_relaxed);
+    snapshot.sum_ += sum_.load(std::memory_order_relaxed);
+}
+
+}  // namespace ion
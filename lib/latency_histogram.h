@@ -0,0 +1,95 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+namespace ion {
+
+// Adds to a counter that only the calling thread writes. With a single writer a relaxed load and
+// store is enough, and avoids the locked instruction of fetch_add; readers on other threads may
+// see the old or new value but never a torn one.
+template <typename T>
+void single_writer_add(std::atomic<T>& counter, T delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+// Log-linear bucketing in the style of HdrHistogram: values below SUB_BUCKETS get a bucket each,
+// and every power of two above that is split into SUB_BUCKETS / 2 equal buckets, so a bucket's
+// width is at most 1/32 of its lower bound (about 3% relative error) across the whole range.
+struct LatencyBuckets {
+    static constexpr unsigned SUB_BUCKET_BITS = 6;
+    static constexpr uint64_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr uint64_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+    // larger values are counted as this (in microseconds, a little over 19 hours)
+    static constexpr uint64_t MAX_VALUE = (uint64_t{1} << 36) - 1;
+    static constexpr size_t COUNT = (std::bit_width(MAX_VALUE) - SUB_BUCKET_BITS + 2) *
+                                    HALF_SUB_BUCKETS;
+
+    static constexpr size_t index_of(uint64_t value) {
+        if (value > MAX_VALUE) {
+            value = MAX_VALUE;
+        }
+        if (value < SUB_BUCKETS) {
+            return value;
+        }
+        // shift so the value keeps SUB_BUCKET_BITS significant bits, then drop the leading one
+        const auto shift = std::bit_width(value) - SUB_BUCKET_BITS;
+        return (shift + 1) * HALF_SUB_BUCKETS + ((value >> shift) - HALF_SUB_BUCKETS);
+    }
+
+    // smallest value counted in the bucket
+    static constexpr uint64_t lower_bound(size_t index) {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        const auto shift = index / HALF_SUB_BUCKETS - 1;
+        return (index % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS) << shift;
+    }
+
+    // largest value counted in the bucket
+    static constexpr uint64_t upper_bound(size_t index) {
+        return index + 1 == COUNT ? MAX_VALUE : lower_bound(index + 1) - 1;
+    }
+};
+
+// Totals merged from any number of LatencyHistograms.
+class LatencyHistogramSnapshot {
+   public:
+    [[nodiscard]] uint64_t count() const;
+    // sum of the recorded values, before bucketing
+    [[nodiscard]] uint64_t sum() const;
+    // upper bound of the bucket holding the value at this quantile (0 to 1); 0 when empty
+    [[nodiscard]] uint64_t value_at_quantile(double quantile) const;
+    // recorded values no greater than value, to within one bucket
+    [[nodiscard]] uint64_t count_at_or_below(uint64_t value) const;
+
+   private:
+    friend class LatencyHistogram;
+
+    std::array<uint64_t, LatencyBuckets::COUNT> buckets_{};
+    uint64_t count_{};
+    uint64_t sum_{};
+};
+
+// Histogram of durations in microseconds with a single writer: record() is a relaxed load and
+// store per counter, so only one thread may record into an instance, while any thread may take
+// a snapshot. Fixed size, never allocates.
+class LatencyHistogram {
+   public:
+    void record(uint64_t value) {
+        single_writer_add<uint64_t>(buckets_[LatencyBuckets::index_of(value)], 1);
+        single_writer_add<uint64_t>(count_, 1);
+        single_writer_add(sum_, value);
+    }
+
+    // adds this histogram's counts to the snapshot
+    void merge_into(LatencyHistogramSnapshot& snapshot) const;
+
+   private:
+    std::array<std::atomic<uint64_t>, LatencyBuckets::COUNT> buckets_{};
+    std::atomic<uint64_t> count_{};
+    std::atomic<uint64_t> sum_{};
+};
+
+}  // namespace ion
@@ -45,7 +45,7 @@ std::expected<std::vector<PollEvent>, PollError> PollPoller::poll(
 
     const int ret = ::poll(poll_fds.data(), poll_fds.size(), static_cast<int>(timeout.count()));
     if (ret == 0) {
-        spdlog::trace("poll timed out");
+        SPDLOG_TRACE("poll timed out");
         return std::unexpected{PollError::Timeout};
     }
     if (ret < 0) {
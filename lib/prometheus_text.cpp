@@ -0,0 +1,92 @@
+#include "prometheus_text.h"
+
+#include <array>
+#include <charconv>
+#include <format>
+#include <iterator>
+
+namespace ion {
+
+void PrometheusTextWriter::header(std::string_view name, std::string_view type,
+                                  std::string_view help) {
+    std::format_to(std::back_inserter(out_), "# HELP {} {}\n# TYPE {} {}\n", name, help, name,
+                   type);
+}
+
+void PrometheusTextWriter::sample(std::string_view name, uint64_t value,
+                                  std::span<const PrometheusLabel> labels) {
+    write_sample(name, {}, value, labels);
+}
+
+void PrometheusTextWriter::sample(std::string_view name, int64_t value,
+                                  std::span<const PrometheusLabel> labels) {
+    write_sample(name, {}, value, labels);
+}
+
+void PrometheusTextWriter::sample(std::string_view name, double value,
+                                  std::span<const PrometheusLabel> labels) {
+    write_sample(name, {}, value, labels);
+}
+
+void PrometheusTextWriter::histogram_seconds(std::string_view name, std::string_view help,
+                                             const LatencyHistogramSnapshot& histogram,
+                                             std::span<const uint64_t> bounds_us) {
+    header(name, "histogram", help);
+
+    std::array<char, 32> le{};
+    for (const auto bound : bounds_us) {
+        // fixed notation, so the label reads "0.0001" rather than "1e-04"
+        const auto end = std::to_chars(le.data(), le.data() + le.size(),
+                                       static_cast<double>(bound) / 1'000'000,
+                                       std::chars_format::fixed)
+                             .ptr;
+        const PrometheusLabel label{"le", {le.data(), end}};
+        write_sample(name, "_bucket", histogram.count_at_or_below(bound), {&label, 1});
+    }
+    const PrometheusLabel inf{"le", "+Inf"};
+    write_sample(name, "_bucket", histogram.count(), {&inf, 1});
+
+    write_sample(name, "_sum", static_cast<double>(histogram.sum()) / 1'000'000, {});
+    write_sample(name, "_count", histogram.count(), {});
+}
+
+void PrometheusTextWriter::append(std::string_view text) {
+    out_.insert(out_.end(), text.begin(), text.end());
+}
+
+template <typename T>
+void PrometheusTextWriter::write_sample(std::string_view name, std::string_view suffix, T value,
+                                        std::span<const PrometheusLabel> labels) {
+    append(name);
+    append(suffix);
+    if (!labels.empty()) {
+        out_.push_back('{');
+        for (size_t i = 0; i < labels.size(); i++) {
+            if (i != 0) {
+                out_.push_back(',');
+            }
+            append(labels[i].name);
+            append("=\"");
+            for (const char c : labels[i].value) {
+                switch (c) {
+                    case '\\':
+                        append("\\\\");
+                        break;
+                    case '"':
+                        append("\\\"");
+                        break;
+                    case '\n':
+                        append("\\n");
+                        break;
+                    default:
+                        out_.push_back(static_cast<uint8_t>(c));
+                }
+            }
+            out_.push_back('"');
+        }
+        out_.push_back('}');
+    }
+    std::format_to(std::back_inserter(out_), " {}\n", value);
+}
+
+}  // namespace ion
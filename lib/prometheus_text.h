@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "latency_histogram.h"
+
+namespace ion {
+
+struct PrometheusLabel {
+    std::string_view name;
+    std::string_view value;
+};
+
+// Appends metrics in the Prometheus text exposition format (version 0.0.4) to a caller-owned
+// buffer, which can be sent as a response body as it is. A buffer kept between scrapes is
+// reused, so rendering doesn't allocate once it has grown to fit. Write a family's header()
+// before its samples.
+class PrometheusTextWriter {
+   public:
+    static constexpr std::string_view CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8";
+
+    explicit PrometheusTextWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    // type is "counter", "gauge" or "histogram"
+    void header(std::string_view name, std::string_view type, std::string_view help);
+    void sample(std::string_view name, uint64_t value,
+                std::span<const PrometheusLabel> labels = {});
+    void sample(std::string_view name, int64_t value,
+                std::span<const PrometheusLabel> labels = {});
+    void sample(std::string_view name, double value,
+                std::span<const PrometheusLabel> labels = {});
+    // a whole histogram family from microsecond durations, with "le" buckets at bounds_us
+    // (ascending) converted to seconds
+    void histogram_seconds(std::string_view name, std::string_view help,
+                           const LatencyHistogramSnapshot& histogram,
+                           std::span<const uint64_t> bounds_us);
+
+   private:
+    std::vector<uint8_t>& out_;
+
+    void append(std::string_view text);
+
+    template <typename T>
+    void write_sample(std::string_view name, std::string_view suffix, T value,
+                      std::span<const PrometheusLabel> labels);
+};
+
+}  // namespace ion
@@ -0,0 +1,15 @@
+#pragma once
+#include "http_response.h"
+
+namespace ion {
+
+// Resolves a request to its response. Implemented by the runtime Router and by
+// CompiledRouteTable for routes fixed at build time.
+class RequestDispatcher {
+   public:
+    virtual ~RequestDispatcher() = default;
+
+    virtual HttpResponse dispatch(HttpRequest& req) const = 0;
+};
+
+}  // namespace ion
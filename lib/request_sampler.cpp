@@ -0,0 +1,34 @@
+#include "request_sampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace ion {
+
+// splitmix64; cheap enough to call on every request and seeded separately on each thread
+static uint64_t next_random() {
+    thread_local uint64_t state = std::random_device{}() | (uint64_t{std::random_device{}()} << 32);
+    uint64_t z = (state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+RequestSampler::RequestSampler(double ratio)
+    : ratio_(std::isnan(ratio) ? 0.0 : std::clamp(ratio, 0.0, 1.0)),
+      threshold_(ratio_ >= 1.0 ? std::numeric_limits<uint64_t>::max()
+                               : static_cast<uint64_t>(
+                                     std::ldexp(ratio_, std::numeric_limits<uint64_t>::digits))),
+      always_(ratio_ >= 1.0) {}
+
+bool RequestSampler::sample() const {
+    return always_ || (threshold_ != 0 && next_random() < threshold_);
+}
+
+double RequestSampler::ratio() const {
+    return ratio_;
+}
+
+}  // namespace ion
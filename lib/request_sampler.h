@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+namespace ion {
+
+// Head sampling for request tracing. The decision is made before any span exists, so requests
+// that aren't sampled never call into OpenTelemetry.
+class RequestSampler {
+   public:
+    // ratio is the fraction of requests traced, clamped to [0, 1]
+    explicit RequestSampler(double ratio = 1.0);
+
+    [[nodiscard]] bool sample() const;
+    [[nodiscard]] double ratio() const;
+
+   private:
+    double ratio_;
+    // a request is sampled when a random 64-bit value falls below this
+    uint64_t threshold_;
+    bool always_;
+};
+
+inline const RequestSampler ALWAYS_SAMPLE{};
+
+}  // namespace ion
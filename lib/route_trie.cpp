@@ -0,0 +1,192 @@
+#include "route_trie.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+namespace ion {
+
+struct RouteTrie::Node {
+    // static text consumed on the edge into this node (empty for parameter nodes)
+    std::string prefix{};
+    std::string param_name{};
+    // static children, each starting with a distinct character
+    std::vector<std::unique_ptr<Node>> children{};
+    std::unique_ptr<Node> param_child{};
+    std::unique_ptr<Node> wildcard_child{};
+    std::vector<MethodRoute> methods{};
+
+    [[nodiscard]] const MethodRoute* route_for(HttpMethod method,
+                                               std::string_view method_name) const {
+        for (const auto& route : methods) {
+            if (route.method == method &&
+                (method != HttpMethod::Other || route.method_name == method_name)) {
+                return &route;
+            }
+        }
+        return nullptr;
+    }
+};
+
+RouteTrie::RouteTrie() : root_(std::make_unique<Node>()) {}
+
+RouteTrie::~RouteTrie() = default;
+
+RouteTrie::RouteTrie(RouteTrie&&) noexcept = default;
+
+RouteTrie& RouteTrie::operator=(RouteTrie&&) noexcept = default;
+
+// length of the leading static text, up to the first segment starting with ':' or '*'
+static size_t static_prefix_length(std::string_view pattern) {
+    for (size_t i = 1; i < pattern.size(); i++) {
+        if ((pattern[i] == ':' || pattern[i] == '*') && pattern[i - 1] == '/') {
+            return i;
+        }
+    }
+    return pattern.size();
+}
+
+void RouteTrie::insert(std::string_view pattern, std::string_view method,
+                       const RouteHandler& handler, const Middleware& middleware) {
+    const auto full_pattern = pattern;
+    Node* node = root_.get();
+
+    const auto dynamic_child = [&](std::unique_ptr<Node>& child, std::string_view name) {
+        if (name.empty()) {
+            throw std::invalid_argument(std::format("unnamed route parameter: {}", full_pattern));
+        }
+        if (!child) {
+            child = std::make_unique<Node>();
+            child->param_name = name;
+        } else if (child->param_name != name) {
+            throw std::invalid_argument(std::format(
+                "conflicting route parameter names '{}' and '{}'", child->param_name, name));
+        }
+        return child.get();
+    };
+
+    while (!pattern.empty()) {
+        if (pattern.front() == ':') {
+            const auto name = pattern.substr(1, pattern.find('/') - 1);
+            node = dynamic_child(node->param_child, name);
+            pattern.remove_prefix(name.size() + 1);
+            continue;
+        }
+        if (pattern.front() == '*') {
+            const auto name = pattern.substr(1);
+            if (name.find('/') != std::string_view::npos) {
+                throw std::invalid_argument(
+                    std::format("wildcard must be the last route segment: {}", full_pattern));
+            }
+            node = dynamic_child(node->wildcard_child, name);
+            pattern = {};
+            continue;
+        }
+
+        const auto text = pattern.substr(0, static_prefix_length(pattern));
+        auto it = std::ranges::find_if(node->children, [&](const auto& child) {
+            return child->prefix.front() == text.front();
+        });
+        if (it == node->children.end()) {
+            auto child = std::make_unique<Node>();
+            child->prefix = text;
+            node = node->children.emplace_back(std::move(child)).get();
+            pattern.remove_prefix(text.size());
+            continue;
+        }
+
+        auto& child = *it;
+        const auto common = static_cast<size_t>(
+            std::ranges::mismatch(child->prefix, text).in1 - child->prefix.begin());
+        if (common < child->prefix.size()) {
+            // split the edge so the shared prefix becomes its own node
+            auto split = std::make_unique<Node>();
+            split->prefix = child->prefix.substr(0, common);
+            child->prefix.erase(0, common);
+            split->children.push_back(std::move(child));
+            child = std::move(split);
+        }
+        node = child.get();
+        pattern.remove_prefix(common);
+    }
+
+    const auto method_type = HttpMethodHelper::from_string(method);
+    if (node->route_for(method_type, method)) {
+        spdlog::warn("route already registered, ignoring: {} {}", method, full_pattern);
+        return;
+    }
+    node->methods.push_back({method_type,
+                             method_type == HttpMethod::Other ? std::string{method} : std::string{},
+                             std::string{full_pattern}, handler, middleware(handler)});
+}
+
+void RouteTrie::compose(const Middleware& middleware) {
+    compose(*root_, middleware);
+}
+
+void RouteTrie::compose(Node& node, const Middleware& middleware) {
+    for (auto& route : node.methods) {
+        route.composed = middleware(route.handler);
+    }
+    for (auto& child : node.children) {
+        compose(*child, middleware);
+    }
+    if (node.param_child) {
+        compose(*node.param_child, middleware);
+    }
+    if (node.wildcard_child) {
+        compose(*node.wildcard_child, middleware);
+    }
+}
+
+const MethodRoute* RouteTrie::find(std::string_view path, HttpMethod method,
+                                   std::string_view method_name,
+                                   std::vector<RouteParam>& params) const {
+    return find(*root_, path, method, method_name, params);
+}
+
+const MethodRoute* RouteTrie::find(const Node& node, std::string_view path, HttpMethod method,
+                                   std::string_view method_name,
+                                   std::vector<RouteParam>& params) {
+    if (path.empty()) {
+        if (const auto* route = node.route_for(method, method_name)) {
+            return route;
+        }
+    } else {
+        for (const auto& child : node.children) {
+            if (child->prefix.front() == path.front()) {
+                if (path.starts_with(child->prefix)) {
+                    if (const auto* route = find(*child, path.substr(child->prefix.size()),
+                                                 method, method_name, params)) {
+                        return route;
+                    }
+                }
+                break;
+            }
+        }
+
+        if (node.param_child) {
+            const auto segment = path.substr(0, path.find('/'));
+            if (!segment.empty()) {
+                params.push_back({node.param_child->param_name, std::string{segment}});
+                if (const auto* route = find(*node.param_child, path.substr(segment.size()),
+                                             method, method_name, params)) {
+                    return route;
+                }
+                params.pop_back();
+            }
+        }
+    }
+
+    if (node.wildcard_child) {
+        if (const auto* route = node.wildcard_child->route_for(method, method_name)) {
+            params.push_back({node.wildcard_child->param_name, std::string{path}});
+            return route;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace ion
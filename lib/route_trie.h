@@ -0,0 +1,56 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "http_response.h"
+
+namespace ion {
+
+using RouteHandler = std::function<HttpResponse(const HttpRequest&)>;
+using Middleware = std::function<RouteHandler(RouteHandler)>;
+
+struct MethodRoute {
+    HttpMethod method;
+    // only set for HttpMethod::Other
+    std::string method_name;
+    // as registered, e.g. "/users/:id"
+    std::string pattern;
+    RouteHandler handler;
+    RouteHandler composed;
+};
+
+// Compressed radix tree of route patterns. Static text shares prefixes along edges, ":name"
+// matches one path segment and "*name" (last segment only) matches the rest of the path. Lookup
+// walks the path once, preferring static over parameter over wildcard matches at each node.
+// Each handler is stored alongside its composition with the middleware stack, so a lookup hands
+// back a ready-to-call handler.
+class RouteTrie {
+   public:
+    RouteTrie();
+    ~RouteTrie();
+    RouteTrie(RouteTrie&&) noexcept;
+    RouteTrie& operator=(RouteTrie&&) noexcept;
+    RouteTrie(const RouteTrie&) = delete;
+    RouteTrie& operator=(const RouteTrie&) = delete;
+
+    void insert(std::string_view pattern, std::string_view method, const RouteHandler& handler,
+                const Middleware& middleware);
+    void compose(const Middleware& middleware);
+    // method_name is only consulted for HttpMethod::Other
+    const MethodRoute* find(std::string_view path, HttpMethod method,
+                            std::string_view method_name, std::vector<RouteParam>& params) const;
+
+   private:
+    struct Node;
+    std::unique_ptr<Node> root_;
+
+    static void compose(Node& node, const Middleware& middleware);
+    static const MethodRoute* find(const Node& node, std::string_view path, HttpMethod method,
+                                   std::string_view method_name,
+                                   std::vector<RouteParam>& params);
+};
+
+}  // namespace ion
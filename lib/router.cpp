@@ -1,48 +1,74 @@
 #include "router.h"
 
+#include <algorithm>
+#include <functional>
+
 #include "spdlog/spdlog.h"
 
 namespace ion {
 
 Router::Router() {
     default_handler_ = [](auto&) { return HttpResponse{404}; };
+    composed_default_handler_ = default_handler_;
 }
 
-RouteHandler Router::get_handler(const std::string& path, const std::string& method) const {
-    RouteHandler target = default_handler_;
+const RouteHandler& Router::get_handler(const std::string& path, const std::string& method) const {
+    return match(path, method).handler;
+}
 
-    bool found = false;
-    for (const auto& route : routes_) {
-        if (route.path == path && route.method == method) {
-            target = route.handler;
-            found = true;
-            break;
-        }
-    }
+HttpResponse Router::dispatch(HttpRequest& req) const {
+    auto [handler, params, route] = match(req.path, req.method, req.method_name);
+    req.params = std::move(params);
+    req.route = route;
+    return handler(req);
+}
+
+RouteMatch Router::match(const std::string& path, const std::string& method) const {
+    return match(path, HttpMethodHelper::from_string(method), method);
+}
 
-    if (!found) {
-        if (method == "GET" || method == "HEAD") {
-            for (const auto& handler : static_handlers_) {
-                if (handler->matches(path)) {
-                    target = [&handler, path, &method](const HttpRequest&) -> HttpResponse {
-                        return handler->handle(path, method == "HEAD");
-                    };
-                }
+RouteMatch Router::match(std::string_view path, HttpMethod method,
+                         std::string_view method_name) const {
+    // routes match on the path alone, without any query string
+    const auto route_path = path.substr(0, path.find('?'));
+
+    RouteMatch result{.handler = composed_default_handler_};
+    if (const auto* route = routes_.find(route_path, method, method_name, result.params)) {
+        result.handler = route->composed;
+        result.route = route->pattern;
+    } else if (method == HttpMethod::Get || method == HttpMethod::Head) {
+        for (const auto& mount : static_mounts_) {
+            if (mount.file_handler->matches(path)) {
+                result.handler = mount.composed;
+                result.route = mount.file_handler->url_prefix();
+                break;
             }
         }
     }
+    return result;
+}
 
-    return middleware_chain_(std::move(target));
+RouteHandler Router::static_file_route(const StaticFileHandler& file_handler) {
+    return [&file_handler](const HttpRequest& req) {
+        return file_handler.handle(req.path, req.method == HttpMethod::Head);
+    };
 }
 
 void Router::add_route(const std::string& path, const std::string& method,
                        const RouteHandler& handler) {
-    const Route route{path, method, handler};
-    routes_.push_back(route);
+    routes_.insert(path, method, handler, middleware_chain_);
+}
+
+void Router::add_route(const std::string& path, HttpMethod method, const RouteHandler& handler) {
+    add_route(path, std::string{HttpMethodHelper::to_string(method)}, handler);
 }
 
 void Router::add_static_handler(std::unique_ptr<StaticFileHandler> handler) {
-    static_handlers_.push_back(std::move(handler));
+    const auto pos = std::ranges::upper_bound(
+        static_mounts_, handler->url_prefix().size(), std::greater{},
+        [](const auto& mount) { return mount.file_handler->url_prefix().size(); });
+    auto composed = middleware_chain_(static_file_route(*handler));
+    static_mounts_.insert(pos, {std::move(handler), std::move(composed)});
 }
 
 void Router::add_middleware(Middleware mw) {
@@ -50,6 +76,12 @@ void Router::add_middleware(Middleware mw) {
     middleware_chain_ = [current_chain, mw](RouteHandler h) {
         return current_chain(mw(std::move(h)));
     };
+
+    routes_.compose(middleware_chain_);
+    for (auto& mount : static_mounts_) {
+        mount.composed = middleware_chain_(static_file_route(*mount.file_handler));
+    }
+    composed_default_handler_ = middleware_chain_(default_handler_);
 }
 
 }  // namespace ion
@@ -5,33 +5,51 @@
 #include <vector>
 
 #include "http_response.h"
+#include "request_dispatcher.h"
+#include "route_trie.h"
 #include "static_file_handler.h"
 
 namespace ion {
 
-using RouteHandler = std::function<HttpResponse(const HttpRequest&)>;
-using Middleware = std::function<RouteHandler(RouteHandler)>;
+struct RouteMatch {
+    std::reference_wrapper<const RouteHandler> handler;
+    std::vector<RouteParam> params{};
+    // pattern of the matching route or static mount's URL prefix; empty for the default handler
+    std::string_view route{};
+};
 
-struct Route {
-    std::string path;
-    std::string method;
-    RouteHandler handler;
+struct StaticMount {
+    std::unique_ptr<StaticFileHandler> file_handler;
+    RouteHandler composed;
 };
 
-class Router {
+class Router : public RequestDispatcher {
    public:
     Router();
 
-    RouteHandler get_handler(const std::string& path, const std::string& method) const;
+    HttpResponse dispatch(HttpRequest& req) const override;
+    const RouteHandler& get_handler(const std::string& path, const std::string& method) const;
+    RouteMatch match(const std::string& path, const std::string& method) const;
+    // routes match on the path up to any '?', so a query string never stops a route matching;
+    // static mounts see the whole path. method_name is only consulted for HttpMethod::Other
+    RouteMatch match(std::string_view path, HttpMethod method,
+                     std::string_view method_name = {}) const;
     void add_route(const std::string& path, const std::string& method, const RouteHandler& handler);
+    void add_route(const std::string& path, HttpMethod method, const RouteHandler& handler);
     void add_static_handler(std::unique_ptr<StaticFileHandler> handler);
     void add_middleware(Middleware mw);
 
    private:
-    std::vector<Route> routes_{};
-    std::vector<std::unique_ptr<StaticFileHandler>> static_handlers_;
+    // handlers are composed with the middleware chain when registered (and recomposed when
+    // middleware is added) so dispatch never builds closures per request
+    RouteTrie routes_{};
+    // ordered by descending URL prefix length so the first match is the longest
+    std::vector<StaticMount> static_mounts_;
     RouteHandler default_handler_;
+    RouteHandler composed_default_handler_;
     Middleware middleware_chain_ = [](auto handler) { return handler; };
+
+    static RouteHandler static_file_route(const StaticFileHandler& file_handler);
 };
 
 }  // namespace ion
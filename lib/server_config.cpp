@@ -1,5 +1,7 @@
 #include "server_config.h"
 
+#include <stdexcept>
+
 namespace ion {
 
 void ServerConfiguration::validate() const {
@@ -11,6 +13,9 @@ void ServerConfiguration::validate() const {
             throw std::runtime_error("TLS private key path not set.");
         }
     }
+    if (!(trace_sample_ratio >= 0.0 && trace_sample_ratio <= 1.0)) {
+        throw std::invalid_argument("trace sample ratio must be between 0 and 1.");
+    }
 }
 
 }  // namespace ion
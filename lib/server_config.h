@@ -2,7 +2,9 @@
 #include <filesystem>
 #include <optional>
 
+#include "hpack/indexing_policy.h"
 #include "router.h"
+#include "transports/tls_context.h"
 
 namespace ion {
 
@@ -11,6 +13,12 @@ struct ServerConfiguration {
     std::optional<std::filesystem::path> key_path;
     bool cleartext;
     std::string custom_404_path;
+    IndexingPolicyConfig hpack_indexing{};
+    TlsOptions tls{};
+    // TLS handshakes run on this many worker threads instead of the event loop (0 disables)
+    size_t handshake_threads{};
+    // fraction of requests traced with OpenTelemetry; the rest skip span creation entirely
+    double trace_sample_ratio{1.0};
 
     void validate() const;
 };
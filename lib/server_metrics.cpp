@@ -0,0 +1,145 @@
+#include "server_metrics.h"
+
+#include <opentelemetry/context/context.h>
+#include <opentelemetry/metrics/provider.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ion {
+
+namespace metrics_api = opentelemetry::metrics;
+
+namespace {
+
+std::mutex registry_mutex{};
+std::vector<std::unique_ptr<LoopMetrics>> registry{};
+
+struct Instruments {
+    opentelemetry::nostd::shared_ptr<metrics_api::Meter> meter;
+    opentelemetry::nostd::unique_ptr<metrics_api::Histogram<double>> request_duration;
+    opentelemetry::nostd::unique_ptr<metrics_api::Histogram<double>> handshake_duration;
+};
+
+// looked up once per event loop thread, like the request tracer. The SDK aggregates recorded
+// values into buckets in place, so nothing is kept per request
+Instruments& instruments() {
+    thread_local Instruments instruments = [] {
+        auto meter = metrics_api::Provider::GetMeterProvider()->GetMeter("ion");
+        auto request_duration = meter->CreateDoubleHistogram(
+            "http.server.request.duration", "Duration of HTTP server requests", "s");
+        auto handshake_duration = meter->CreateDoubleHistogram(
+            "ion.connection.handshake.duration",
+            "Time from accepting a connection to completing its transport handshake", "s");
+        return Instruments{std::move(meter), std::move(request_duration),
+                           std::move(handshake_duration)};
+    }();
+    return instruments;
+}
+
+double to_seconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+}  // namespace
+
+LoopMetrics& ServerMetrics::local() {
+    thread_local LoopMetrics* metrics = [] {
+        std::lock_guard lock{registry_mutex};
+        return registry.emplace_back(std::make_unique<LoopMetrics>()).get();
+    }();
+    return *metrics;
+}
+
+ServerMetricsSnapshot ServerMetrics::snapshot() {
+    ServerMetricsSnapshot totals{};
+    std::lock_guard lock{registry_mutex};
+    for (const auto& loop : registry) {
+        totals.active_connections += loop->active_connections.load(std::memory_order_relaxed);
+        totals.active_streams += loop->active_streams.load(std::memory_order_relaxed);
+        totals.bytes_received += loop->bytes_received.load(std::memory_order_relaxed);
+        totals.bytes_sent += loop->bytes_sent.load(std::memory_order_relaxed);
+        totals.hpack_decoder_table_bytes +=
+            loop->hpack_decoder_table_bytes.load(std::memory_order_relaxed);
+        totals.hpack_encoder_table_bytes +=
+            loop->hpack_encoder_table_bytes.load(std::memory_order_relaxed);
+    }
+    return totals;
+}
+
+RequestMetricsSnapshot ServerMetrics::request_snapshot() {
+    RequestMetricsSnapshot totals{};
+    std::lock_guard lock{registry_mutex};
+    for (const auto& loop : registry) {
+        for (size_t code = 0; code < loop->status_codes.size(); code++) {
+            totals.status_codes[code] += loop->status_codes[code].load(std::memory_order_relaxed);
+        }
+        loop->request_latency.merge_into(totals.latency);
+    }
+    totals.total_requests = totals.latency.count();
+    return totals;
+}
+
+void ServerMetrics::record_request(std::string_view route, uint16_t status_code,
+                                   std::chrono::steady_clock::duration duration) {
+    auto& loop = local();
+    const bool known_code = status_code <= RequestMetricsSnapshot::MAX_STATUS_CODE;
+    single_writer_add<uint64_t>(loop.status_codes[known_code ? status_code : 0], 1);
+    const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    loop.request_latency.record(static_cast<uint64_t>(std::max<int64_t>(micros, 0)));
+
+    const opentelemetry::common::AttributeValue status = static_cast<int64_t>(status_code);
+    auto& histogram = *instruments().request_duration;
+    if (route.empty()) {
+        histogram.Record(to_seconds(duration), {{"http.response.status_code", status}},
+                         opentelemetry::context::Context{});
+        return;
+    }
+    histogram.Record(to_seconds(duration),
+                     {{"http.route", opentelemetry::nostd::string_view{route.data(), route.size()}},
+                      {"http.response.status_code", status}},
+                     opentelemetry::context::Context{});
+}
+
+void ServerMetrics::record_handshake(std::chrono::steady_clock::duration duration) {
+    instruments().handshake_duration->Record(to_seconds(duration),
+                                             opentelemetry::context::Context{});
+}
+
+ConnectionMetrics::ConnectionMetrics() : loop_(ServerMetrics::local()) {
+    single_writer_add<int64_t>(loop_.active_connections, 1);
+}
+
+ConnectionMetrics::~ConnectionMetrics() {
+    single_writer_add<int64_t>(loop_.active_connections, -1);
+    set_active_streams(0);
+    set_hpack_table_sizes(0, 0);
+}
+
+void ConnectionMetrics::set_active_streams(int64_t streams) {
+    single_writer_add(loop_.active_streams, streams - active_streams_);
+    active_streams_ = streams;
+}
+
+void ConnectionMetrics::set_hpack_table_sizes(int64_t decoder_bytes, int64_t encoder_bytes) {
+    single_writer_add(loop_.hpack_decoder_table_bytes, decoder_bytes - hpack_decoder_table_bytes_);
+    single_writer_add(loop_.hpack_encoder_table_bytes, encoder_bytes - hpack_encoder_table_bytes_);
+    hpack_decoder_table_bytes_ = decoder_bytes;
+    hpack_encoder_table_bytes_ = encoder_bytes;
+}
+
+void ConnectionMetrics::add_received(uint64_t bytes) {
+    single_writer_add(loop_.bytes_received, bytes);
+}
+
+void ConnectionMetrics::add_sent(uint64_t bytes) {
+    single_writer_add(loop_.bytes_sent, bytes);
+}
+
+void ConnectionMetrics::handshake_complete() {
+    ServerMetrics::record_handshake(std::chrono::steady_clock::now() - created_);
+}
+
+}  // namespace ion
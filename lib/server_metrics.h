@@ -0,0 +1,91 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+#include "latency_histogram.h"
+
+namespace ion {
+
+// Totals behind the exported connection metrics, summed over every event loop thread.
+struct ServerMetricsSnapshot {
+    int64_t active_connections;
+    int64_t active_streams;
+    uint64_t bytes_received;
+    uint64_t bytes_sent;
+    // bytes held by the HPACK dynamic tables (as counted by RFC 7541 4.1) of open connections
+    int64_t hpack_decoder_table_bytes;
+    int64_t hpack_encoder_table_bytes;
+};
+
+// Responses sent so far, summed over every event loop thread.
+struct RequestMetricsSnapshot {
+    // responses with a status code above this are counted under 0
+    static constexpr uint16_t MAX_STATUS_CODE = 599;
+
+    uint64_t total_requests{};
+    // indexed by status code
+    std::array<uint64_t, MAX_STATUS_CODE + 1> status_codes{};
+    // time taken to produce each response, in microseconds
+    LatencyHistogramSnapshot latency{};
+};
+
+// Counters of one event loop thread. Only the owning thread writes them, so an update is a relaxed
+// load and store (no locked instruction) on a cache line no other thread writes; readers sum
+// every thread's counters when metrics are collected.
+struct alignas(64) LoopMetrics {
+    std::atomic<int64_t> active_connections{};
+    std::atomic<int64_t> active_streams{};
+    std::atomic<uint64_t> bytes_received{};
+    std::atomic<uint64_t> bytes_sent{};
+    std::atomic<int64_t> hpack_decoder_table_bytes{};
+    std::atomic<int64_t> hpack_encoder_table_bytes{};
+    std::array<std::atomic<uint64_t>, RequestMetricsSnapshot::MAX_STATUS_CODE + 1> status_codes{};
+    LatencyHistogram request_latency{};
+};
+
+class ServerMetrics {
+   public:
+    // the calling thread's counters, registered on first use and kept for the process lifetime
+    static LoopMetrics& local();
+    static ServerMetricsSnapshot snapshot();
+    // status codes and latencies of every response, for the status and metrics pages
+    static RequestMetricsSnapshot request_snapshot();
+
+    // counted in the calling thread's LoopMetrics, and recorded on the global OpenTelemetry
+    // meter provider, a no-op until one is installed; install it before the server starts, as
+    // instruments are looked up once per thread
+    static void record_request(std::string_view route, uint16_t status_code,
+                               std::chrono::steady_clock::duration duration);
+    static void record_handshake(std::chrono::steady_clock::duration duration);
+};
+
+// A connection's share of its thread's gauges. Whatever it still holds is taken back when it is
+// destroyed, so the gauges stay right however the connection ends. Must be created and destroyed
+// on the same thread.
+class ConnectionMetrics {
+   public:
+    ConnectionMetrics();
+    ~ConnectionMetrics();
+
+    ConnectionMetrics(const ConnectionMetrics&) = delete;
+    ConnectionMetrics& operator=(const ConnectionMetrics&) = delete;
+
+    void set_active_streams(int64_t streams);
+    void set_hpack_table_sizes(int64_t decoder_bytes, int64_t encoder_bytes);
+    void add_received(uint64_t bytes);
+    void add_sent(uint64_t bytes);
+    // records the time since the connection was accepted
+    void handshake_complete();
+
+   private:
+    LoopMetrics& loop_;
+    std::chrono::steady_clock::time_point created_{std::chrono::steady_clock::now()};
+    int64_t active_streams_{};
+    int64_t hpack_decoder_table_bytes_{};
+    int64_t hpack_encoder_table_bytes_{};
+};
+
+}  // namespace ion
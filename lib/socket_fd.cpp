@@ -58,7 +58,7 @@ SocketFd::operator int() const noexcept {
 
 void SocketFd::close() noexcept {
     if (fd_ >= 0) {
-        spdlog::trace("closing socket fd {}", fd_);
+        SPDLOG_TRACE("closing socket fd {}", fd_);
         ::close(fd_);
         fd_ = -1;
     }
@@ -0,0 +1,63 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+
+namespace ion {
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread. Slots are
+// filled and read in place (claim/commit, front/pop) so large records aren't copied twice.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(std::has_single_bit(Capacity), "capacity must be a power of two");
+
+   public:
+    // producer: a slot to fill, or nullptr if the ring is full
+    T* try_claim() {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head - tail_cache_ == Capacity) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head - tail_cache_ == Capacity) {
+                return nullptr;
+            }
+        }
+        return &slots_[head & MASK];
+    }
+
+    // producer: publishes the slot returned by try_claim()
+    void commit() {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // consumer: the oldest published slot, or nullptr if the ring is empty
+    const T* front() {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_cache_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail == head_cache_) {
+                return nullptr;
+            }
+        }
+        return &slots_[tail & MASK];
+    }
+
+    // consumer: releases the slot returned by front()
+    void pop() {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+   private:
+    static constexpr size_t MASK = Capacity - 1;
+    static constexpr size_t CACHE_LINE = 64;
+
+    // each side keeps a stale copy of the other's index so it only touches the other side's
+    // cache line when the ring looks full (or empty)
+    alignas(CACHE_LINE) std::atomic<size_t> head_{};
+    size_t tail_cache_{};
+    alignas(CACHE_LINE) std::atomic<size_t> tail_{};
+    size_t head_cache_{};
+    alignas(CACHE_LINE) std::array<T, Capacity> slots_{};
+};
+
+}  // namespace ion
@@ -0,0 +1,107 @@
+#include "static_file_cache.h"
+
+#include <spdlog/spdlog.h>
+#include <sys/stat.h>
+
+namespace ion {
+
+std::optional<FileStamp> FileStamp::of(const std::string& path) {
+    struct stat st{};
+    if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        return std::nullopt;
+    }
+#if defined(__APPLE__)
+    const auto& mtime = st.st_mtimespec;
+#else
+    const auto& mtime = st.st_mtim;
+#endif
+    return FileStamp{.size = static_cast<size_t>(st.st_size),
+                     .mtime_ns = static_cast<int64_t>(mtime.tv_sec) * 1'000'000'000 +
+                                 static_cast<int64_t>(mtime.tv_nsec)};
+}
+
+StaticFileCache::StaticFileCache(const StaticFileCacheConfig& config) : config_(config) {}
+
+const CachedFile* StaticFileCache::find(const std::string& key, Clock::time_point now) {
+    const auto it = index_.find(key);
+    if (it == index_.end()) {
+        misses_++;
+        return nullptr;
+    }
+
+    auto& file = it->second->second;
+    if (now - file.validated_at >= config_.revalidate_interval) {
+        if (FileStamp::of(file.path) != file.stamp) {
+            SPDLOG_DEBUG("static file changed on disk, evicting from cache: {}", file.path);
+            erase(it->second);
+            misses_++;
+            return nullptr;
+        }
+        file.validated_at = now;
+    }
+
+    lru_.splice(lru_.begin(), lru_, it->second);
+    hits_++;
+    return &file;
+}
+
+void StaticFileCache::insert(const std::string& key, CachedFile file, Clock::time_point now) {
+    const auto size = file.content->size();
+    if (!admits(size)) {
+        return;
+    }
+
+    erase(key);
+    evict_to(config_.max_bytes - size);
+
+    file.validated_at = now;
+    lru_.emplace_front(key, std::move(file));
+    index_.emplace(key, lru_.begin());
+    size_bytes_ += size;
+}
+
+bool StaticFileCache::admits(size_t size) const {
+    return config_.max_bytes > 0 && size <= config_.max_entry_bytes && size <= config_.max_bytes;
+}
+
+void StaticFileCache::erase(const std::string& key) {
+    if (const auto it = index_.find(key); it != index_.end()) {
+        erase(it->second);
+    }
+}
+
+void StaticFileCache::erase(std::list<Entry>::iterator it) {
+    size_bytes_ -= it->second.content->size();
+    index_.erase(it->first);
+    lru_.erase(it);
+}
+
+void StaticFileCache::evict_to(size_t max_bytes) {
+    while (size_bytes_ > max_bytes && !lru_.empty()) {
+        SPDLOG_DEBUG("evicting static file from cache: {}", lru_.back().second.path);
+        erase(std::prev(lru_.end()));
+        evictions_++;
+    }
+}
+
+size_t StaticFileCache::size_bytes() const {
+    return size_bytes_;
+}
+
+size_t StaticFileCache::count() const {
+    return lru_.size();
+}
+
+uint64_t StaticFileCache::hits() const {
+    return hits_;
+}
+
+uint64_t StaticFileCache::misses() const {
+    return misses_;
+}
+
+uint64_t StaticFileCache::evictions() const {
+    return evictions_;
+}
+
+}  // namespace ion
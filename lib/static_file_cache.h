@@ -0,0 +1,80 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ion {
+
+struct StaticFileCacheConfig {
+    // total bytes of file content held; 0 disables caching
+    size_t max_bytes{64 * 1024 * 1024};
+    // larger files are always read from disk
+    size_t max_entry_bytes{1024 * 1024};
+    // entries younger than this are served without touching the filesystem
+    std::chrono::milliseconds revalidate_interval{1000};
+};
+
+struct FileStamp {
+    size_t size;
+    int64_t mtime_ns;
+
+    bool operator==(const FileStamp&) const = default;
+
+    // stats a regular file; nullopt if missing or not a regular file
+    static std::optional<FileStamp> of(const std::string& path);
+};
+
+struct CachedFile {
+    std::string path;
+    std::string mime_type;
+    // shared with every response served from the cache, so hits don't copy the file
+    std::shared_ptr<const std::vector<uint8_t>> content;
+    FileStamp stamp;
+    std::chrono::steady_clock::time_point validated_at{};
+};
+
+// LRU cache of static file content keyed by request path. Not thread-safe: each handler owns
+// one and it is only used from the server's event loop.
+class StaticFileCache {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit StaticFileCache(const StaticFileCacheConfig& config = {});
+
+    // returns nullptr on a miss or if the file changed on disk since it was cached; the pointer
+    // is invalidated by the next insert
+    const CachedFile* find(const std::string& key, Clock::time_point now = Clock::now());
+    // no-op unless admits() the content
+    void insert(const std::string& key, CachedFile file, Clock::time_point now = Clock::now());
+    void erase(const std::string& key);
+    // whether content of this size fits the per-entry and total budgets
+    [[nodiscard]] bool admits(size_t size) const;
+
+    [[nodiscard]] size_t size_bytes() const;
+    [[nodiscard]] size_t count() const;
+    [[nodiscard]] uint64_t hits() const;
+    [[nodiscard]] uint64_t misses() const;
+    [[nodiscard]] uint64_t evictions() const;
+
+   private:
+    using Entry = std::pair<std::string, CachedFile>;
+
+    StaticFileCacheConfig config_;
+    // most recently used at the front
+    std::list<Entry> lru_{};
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_{};
+    size_t size_bytes_{};
+    uint64_t hits_{};
+    uint64_t misses_{};
+    uint64_t evictions_{};
+
+    void evict_to(size_t max_bytes);
+    void erase(std::list<Entry>::iterator it);
+};
+
+}  // namespace ion
@@ -2,19 +2,46 @@
 
 #include <spdlog/spdlog.h>
 
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
 #include "file_reader.h"
+#include "hpack/header_block_encoder.h"
 #include "http_response.h"
 
 namespace ion {
 
+static std::shared_ptr<const PreEncodedHeaders> content_type_headers(
+    const std::string& mime_type) {
+    // bounded by the set of known MIME types
+    thread_local std::unordered_map<std::string, std::shared_ptr<const PreEncodedHeaders>> cache{};
+
+    auto [it, inserted] = cache.try_emplace(mime_type);
+    if (inserted) {
+        it->second = std::make_shared<const PreEncodedHeaders>(
+            HeaderBlockEncoder::pre_encode({{"content-type", mime_type}}));
+    }
+    return it->second;
+}
+
 StaticFileHandler::StaticFileHandler(const std::string& url_prefix,
-                                     const std::string& filesystem_root)
-    : url_prefix_(url_prefix), filesystem_root_(filesystem_root) {}
+                                     const std::string& filesystem_root,
+                                     const StaticFileCacheConfig& cache_config)
+    : url_prefix_(url_prefix), filesystem_root_(filesystem_root), cache_(cache_config) {}
 
-bool StaticFileHandler::matches(const std::string& path) const {
+bool StaticFileHandler::matches(std::string_view path) const {
     return path.starts_with(url_prefix_);
 }
 
+const std::string& StaticFileHandler::url_prefix() const {
+    return url_prefix_;
+}
+
+const StaticFileCache& StaticFileHandler::cache() const {
+    return cache_;
+}
+
 std::string StaticFileHandler::get_relative_path(const std::string& url_path) const {
     std::string rel_path = url_path.substr(url_prefix_.length());
 
@@ -42,9 +69,24 @@ HttpResponse StaticFileHandler::get_response(const std::string& path,
         return HttpResponse{500};
     }
 
-    spdlog::debug("serving static file: {} ({} bytes, {})", path, content->size(), mime_type);
-    return HttpResponse{
-        .status_code = 200, .body = std::move(*content), .headers = {{"content-type", mime_type}}};
+    SPDLOG_DEBUG("serving static file: {} ({} bytes, {})", path, content->size(), mime_type);
+    return HttpResponse{.status_code = 200,
+                        .body = std::move(*content),
+                        .pre_encoded_headers = content_type_headers(mime_type)};
+}
+
+HttpResponse StaticFileHandler::file_body_response(const std::string& path,
+                                                   const std::string& mime_type) {
+    auto file_body = FileBody::open(path);
+    if (!file_body) {
+        return HttpResponse{500};
+    }
+
+    SPDLOG_DEBUG("streaming static file: {} ({} bytes, {})", path, file_body->length(),
+                 mime_type);
+    return HttpResponse{.status_code = 200,
+                        .pre_encoded_headers = content_type_headers(mime_type),
+                        .file_body = std::move(file_body)};
 }
 
 HttpResponse StaticFileHandler::head_response(const std::string& path,
@@ -55,15 +97,15 @@ HttpResponse StaticFileHandler::head_response(const std::string& path,
         return HttpResponse{500};
     }
 
-    spdlog::debug("Returning metadata for static file: {} ({} bytes, {})", path, *size, mime_type);
-    return HttpResponse{
-        .status_code = 200,
-        .headers = {{"content-length", std::to_string(*size)}, {"content-type", mime_type}}};
+    SPDLOG_DEBUG("Returning metadata for static file: {} ({} bytes, {})", path, *size, mime_type);
+    return HttpResponse{.status_code = 200,
+                        .headers = {{"content-length", std::to_string(*size)}},
+                        .pre_encoded_headers = content_type_headers(mime_type)};
 }
 
 HttpResponse StaticFileHandler::file_response(const std::string& path, bool head_request) {
     if (!FileReader::is_readable(path)) {
-        spdlog::debug("file not found or not readable: {}", path);
+        SPDLOG_DEBUG("file not found or not readable: {}", path);
         return HttpResponse{404};
     }
 
@@ -71,16 +113,60 @@ HttpResponse StaticFileHandler::file_response(const std::string& path, bool head
     return head_request ? head_response(path, mime_type) : get_response(path, mime_type);
 }
 
+HttpResponse StaticFileHandler::cached_response(const CachedFile& file, bool is_head) {
+    SPDLOG_DEBUG("serving cached static file: {} ({} bytes, {})", file.path, file.stamp.size,
+                 file.mime_type);
+    if (is_head) {
+        return HttpResponse{.status_code = 200,
+                            .headers = {{"content-length", std::to_string(file.stamp.size)}},
+                            .pre_encoded_headers = content_type_headers(file.mime_type)};
+    }
+    return HttpResponse{.status_code = 200,
+                        .pre_encoded_headers = content_type_headers(file.mime_type),
+                        .shared_body = file.content};
+}
+
+HttpResponse StaticFileHandler::cached_get_response(const std::string& rel_path,
+                                                    const std::string& path) const {
+    // stat before reading so a write racing the read leaves a stale stamp, which the next
+    // revalidation catches
+    const auto stamp = FileStamp::of(path);
+    if (!stamp || !FileReader::is_readable(path)) {
+        SPDLOG_DEBUG("file not found or not readable: {}", path);
+        return HttpResponse{404};
+    }
+
+    const auto mime_type = FileReader::get_mime_type(path);
+    if (!cache_.admits(stamp->size)) {
+        return file_body_response(path, mime_type);
+    }
+
+    auto response = get_response(path, mime_type);
+    if (response.status_code == 200 && cache_.admits(response.body.size())) {
+        response.shared_body =
+            std::make_shared<const std::vector<uint8_t>>(std::exchange(response.body, {}));
+        cache_.insert(rel_path, CachedFile{.path = path,
+                                           .mime_type = mime_type,
+                                           .content = response.shared_body,
+                                           .stamp = *stamp});
+    }
+    return response;
+}
+
 HttpResponse StaticFileHandler::handle(const std::string& path, bool is_head) const {
     std::string rel_path = get_relative_path(path);
 
+    if (const auto* cached = cache_.find(rel_path)) {
+        return cached_response(*cached, is_head);
+    }
+
     auto safe_path = FileReader::sanitize_path(filesystem_root_, rel_path);
     if (!safe_path) {
         spdlog::warn("invalid file path requested: {}", path);
         return HttpResponse{403};
     }
 
-    return file_response(*safe_path, is_head);
+    return is_head ? file_response(*safe_path, is_head) : cached_get_response(rel_path, *safe_path);
 }
 
 }  // namespace ion
@@ -1,23 +1,34 @@
 #pragma once
 #include <string>
+#include <string_view>
 
 #include "http_response.h"
+#include "static_file_cache.h"
 
 namespace ion {
 
 class StaticFileHandler {
    public:
-    StaticFileHandler(const std::string& url_prefix, const std::string& filesystem_root);
-    bool matches(const std::string& path) const;
+    StaticFileHandler(const std::string& url_prefix, const std::string& filesystem_root,
+                      const StaticFileCacheConfig& cache_config = {});
+    bool matches(std::string_view path) const;
+    const std::string& url_prefix() const;
+    const StaticFileCache& cache() const;
     HttpResponse handle(const std::string& path, bool is_head) const;
     static HttpResponse file_response(const std::string& path, bool head_request);
 
    private:
     std::string url_prefix_;
     std::string filesystem_root_;
+    // keyed by relative request path so hits skip path resolution as well as file reads
+    mutable StaticFileCache cache_;
 
     std::string get_relative_path(const std::string& url_path) const;
+    HttpResponse cached_get_response(const std::string& rel_path, const std::string& path) const;
+    static HttpResponse cached_response(const CachedFile& file, bool is_head);
     static HttpResponse get_response(const std::string& path, const std::string& mime_type);
+    // streams the file rather than reading it into memory; used for files the cache won't hold
+    static HttpResponse file_body_response(const std::string& path, const std::string& mime_type);
     static HttpResponse head_response(const std::string& path, const std::string& mime_type);
 };
 
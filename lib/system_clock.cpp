@@ -1,15 +1,50 @@
 #include "system_clock.h"
 
-#include <chrono>
-
-std::string SystemClock::clf_timestamp() {
-    const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-    std::tm loc_tm;
-    localtime_r(&now, &loc_tm);
-
-    std::string buffer(32, '\0');
-    const size_t len =
-        std::strftime(buffer.data(), buffer.size(), "[%d/%b/%Y:%H:%M:%S %z]", &loc_tm);
-    buffer.resize(len);
-    return buffer;
+#include <array>
+#include <ctime>
+#include <limits>
+
+namespace {
+
+struct CachedTimestamp {
+    time_t second{std::numeric_limits<time_t>::min()};
+    std::array<char, 32> text{};
+    size_t size{};
+
+    template <typename ToTm>
+    std::string_view format(std::chrono::system_clock::time_point time, const char* fmt,
+                            ToTm to_tm) {
+        const auto now = std::chrono::system_clock::to_time_t(time);
+        if (now != second) {
+            std::tm tm;
+            to_tm(&now, &tm);
+            size = std::strftime(text.data(), text.size(), fmt, &tm);
+            second = now;
+        }
+        return {text.data(), size};
+    }
+};
+
+}  // namespace
+
+std::string_view SystemClock::clf_timestamp() {
+    return clf_timestamp(std::chrono::system_clock::now());
+}
+
+std::string_view SystemClock::clf_timestamp(std::chrono::system_clock::time_point time) {
+    // localtime_r may take the tz lock and stat /etc/localtime, so only call it when the
+    // second changes
+    thread_local CachedTimestamp cache{};
+    return cache.format(time, "[%d/%b/%Y:%H:%M:%S %z]", localtime_r);
+}
+
+std::string_view SystemClock::http_date() {
+    return http_date(std::chrono::system_clock::now());
+}
+
+std::string_view SystemClock::http_date(std::chrono::system_clock::time_point time) {
+    // strftime's %a and %b are locale dependent, but the server never calls setlocale so the
+    // "C" locale's English names are used as RFC 9110 requires
+    thread_local CachedTimestamp cache{};
+    return cache.format(time, "%a, %d %b %Y %H:%M:%S GMT", gmtime_r);
 }
@@ -1,11 +1,16 @@
-
-
 #pragma once
 
 #include <chrono>
-#include <string>
+#include <string_view>
 
+// Timestamps are formatted at most once per second per thread; the returned views point into a
+// thread-local cache and stay valid until the next call on the same thread.
 class SystemClock {
    public:
-    static std::string clf_timestamp();
+    // e.g. "[10/Oct/2000:13:55:36 -0700]"
+    static std::string_view clf_timestamp();
+    static std::string_view clf_timestamp(std::chrono::system_clock::time_point time);
+    // IMF-fixdate for the HTTP date header, e.g. "Tue, 10 Oct 2000 20:55:36 GMT"
+    static std::string_view http_date();
+    static std::string_view http_date(std::chrono::system_clock::time_point time);
 };
@@ -0,0 +1,38 @@
+#include "trace_parent.h"
+
+#include <opentelemetry/trace/context.h>
+#include <opentelemetry/trace/propagation/http_trace_context.h>
+
+#include <algorithm>
+#include <string_view>
+
+namespace ion {
+
+static constexpr std::string_view TRACEPARENT_HEADER{"traceparent"};
+
+opentelemetry::nostd::string_view HttpHeaderCarrier::Get(
+    opentelemetry::nostd::string_view key) const noexcept {
+    const std::string_view name{key.data(), key.size()};
+    const auto it = std::ranges::find(headers_, name, &HttpHeader::name);
+    if (it == headers_.end()) {
+        return {};
+    }
+    return {it->value.data(), it->value.size()};
+}
+
+std::optional<TraceParent> TraceParent::extract(const std::vector<HttpHeader>& headers) {
+    if (std::ranges::find(headers, TRACEPARENT_HEADER, &HttpHeader::name) == headers.end()) {
+        return std::nullopt;
+    }
+
+    const HttpHeaderCarrier carrier{headers};
+    opentelemetry::context::Context empty{};
+    auto context = opentelemetry::trace::propagation::HttpTraceContext{}.Extract(carrier, empty);
+    const auto span_context = opentelemetry::trace::GetSpan(context)->GetContext();
+    if (!span_context.IsValid()) {
+        return std::nullopt;
+    }
+    return TraceParent{.context = std::move(context), .sampled = span_context.IsSampled()};
+}
+
+}  // namespace ion
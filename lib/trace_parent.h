@@ -0,0 +1,38 @@
+#pragma once
+#include <opentelemetry/context/context.h>
+#include <opentelemetry/context/propagation/text_map_propagator.h>
+
+#include <optional>
+#include <vector>
+
+#include "hpack/http_header.h"
+
+namespace ion {
+
+// Exposes request headers to OpenTelemetry propagators (read-only). HTTP/2 header names are
+// always lowercase, which is how propagators look them up.
+class HttpHeaderCarrier : public opentelemetry::context::propagation::TextMapCarrier {
+   public:
+    explicit HttpHeaderCarrier(const std::vector<HttpHeader>& headers) : headers_(headers) {}
+
+    opentelemetry::nostd::string_view Get(
+        opentelemetry::nostd::string_view key) const noexcept override;
+    void Set(opentelemetry::nostd::string_view, opentelemetry::nostd::string_view) noexcept
+        override {}
+
+   private:
+    const std::vector<HttpHeader>& headers_;
+};
+
+// The remote parent span of a request, from its W3C traceparent and tracestate headers
+struct TraceParent {
+    // holds the remote span context; pass as StartSpanOptions::parent
+    opentelemetry::context::Context context;
+    bool sampled;
+
+    // nullopt unless the request carries a valid traceparent header; requests without one
+    // return without touching the propagator
+    static std::optional<TraceParent> extract(const std::vector<HttpHeader>& headers);
+};
+
+}  // namespace ion
@@ -0,0 +1,88 @@
+#include "memory_transport.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+
+namespace ion {
+
+void MemoryTransport::feed(std::span<const uint8_t> data) {
+    input_.insert(input_.end(), data.begin(), data.end());
+}
+
+void MemoryTransport::close_input() {
+    input_closed_ = true;
+}
+
+std::span<const uint8_t> MemoryTransport::output() const {
+    return output_;
+}
+
+void MemoryTransport::clear_output() {
+    output_.clear();
+}
+
+bool MemoryTransport::is_shut_down() const {
+    return shut_down_;
+}
+
+std::expected<ssize_t, TransportError> MemoryTransport::read(std::span<uint8_t> buffer) const {
+    if (input_pos_ == input_.size()) {
+        if (input_closed_) {
+            return std::unexpected(TransportError::ConnectionClosed);
+        }
+        return std::unexpected(TransportError::WantReadOrWrite);
+    }
+
+    const size_t count = std::min(buffer.size(), input_.size() - input_pos_);
+    std::copy_n(input_.begin() + static_cast<ptrdiff_t>(input_pos_), count, buffer.begin());
+    input_pos_ += count;
+    if (input_pos_ == input_.size()) {
+        // keep the capacity so steady-state feeding doesn't allocate
+        input_.clear();
+        input_pos_ = 0;
+    }
+    return static_cast<ssize_t>(count);
+}
+
+std::expected<ssize_t, TransportError> MemoryTransport::write(
+    std::span<const uint8_t> buffer) const {
+    if (shut_down_) {
+        return std::unexpected(TransportError::WriteError);
+    }
+    output_.insert(output_.end(), buffer.begin(), buffer.end());
+    return static_cast<ssize_t>(buffer.size());
+}
+
+void MemoryTransport::disable_send_file() {
+    send_file_ = false;
+}
+
+std::expected<ssize_t, TransportError> MemoryTransport::send_file(int file_fd, off_t offset,
+                                                                  size_t count) const {
+    if (shut_down_) {
+        return std::unexpected(TransportError::WriteError);
+    }
+    const auto start = output_.size();
+    output_.resize(start + count);
+    const auto bytes_read = ::pread(file_fd, output_.data() + start, count, offset);
+    output_.resize(start + static_cast<size_t>(std::max<ssize_t>(bytes_read, 0)));
+    if (bytes_read < 0) {
+        return std::unexpected(TransportError::WriteError);
+    }
+    return bytes_read;
+}
+
+bool MemoryTransport::supports_send_file() const {
+    return send_file_;
+}
+
+void MemoryTransport::graceful_shutdown() const {
+    shut_down_ = true;
+}
+
+std::expected<void, TransportError> MemoryTransport::handshake() const {
+    return {};
+}
+
+}  // namespace ion
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "transport.h"
+
+namespace ion {
+
+// In-process transport over byte buffers. Reads drain bytes queued with feed() and writes are
+// captured for output(), so a connection can be driven without sockets (tests, benchmarks).
+class MemoryTransport : public Transport {
+   public:
+    MemoryTransport() = default;
+
+    void feed(std::span<const uint8_t> data);
+    void close_input();
+    [[nodiscard]] std::span<const uint8_t> output() const;
+    void clear_output();
+    [[nodiscard]] bool is_shut_down() const;
+    // makes supports_send_file() false, exercising the buffered fallback for file bodies
+    void disable_send_file();
+
+    std::expected<ssize_t, TransportError> read(std::span<uint8_t> buffer) const override;
+    std::expected<ssize_t, TransportError> write(std::span<const uint8_t> buffer) const override;
+    std::expected<ssize_t, TransportError> send_file(int file_fd, off_t offset,
+                                                     size_t count) const override;
+    [[nodiscard]] bool supports_send_file() const override;
+    void graceful_shutdown() const override;
+    [[nodiscard]] std::expected<void, TransportError> handshake() const override;
+
+   private:
+    // Transport's I/O methods are const, mirroring the fd based transports
+    mutable std::vector<uint8_t> input_{};
+    mutable size_t input_pos_{};
+    mutable std::vector<uint8_t> output_{};
+    mutable bool shut_down_{};
+    bool input_closed_{};
+    bool send_file_{true};
+};
+
+}  // namespace ion
@@ -6,6 +6,12 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#else
+#include <sys/uio.h>
+#endif
+
 namespace ion {
 
 TcpTransport::TcpTransport(SocketFd&& client_fd) : client_fd_(std::move(client_fd)) {}
@@ -23,21 +29,21 @@ TcpTransport& TcpTransport::operator=(TcpTransport&& other) noexcept {
 }
 
 std::expected<ssize_t, TransportError> TcpTransport::read(std::span<uint8_t> buffer) const {
-    spdlog::trace("reading from TCP socket");
+    SPDLOG_TRACE("reading from TCP socket");
     const auto bytes_read = ::read(client_fd_, buffer.data(), buffer.size());
     if (bytes_read < 0) {
         if (errno == EAGAIN || errno == EWOULDBLOCK) {
-            spdlog::trace("TCP want read");
+            SPDLOG_TRACE("TCP want read");
             return std::unexpected(TransportError::WantReadOrWrite);
         }
         spdlog::error("TCP read error: {}", strerror(errno));
         return std::unexpected(TransportError::OtherError);
     }
     if (bytes_read == 0) {
-        spdlog::debug("TCP connection closed");
+        SPDLOG_DEBUG("TCP connection closed");
         return std::unexpected(TransportError::ConnectionClosed);
     }
-    spdlog::trace("successfully read {} bytes from TCP socket", bytes_read);
+    SPDLOG_TRACE("successfully read {} bytes from TCP socket", bytes_read);
     return bytes_read;
 }
 
@@ -45,7 +51,7 @@ std::expected<ssize_t, TransportError> TcpTransport::write(std::span<const uint8
     const auto bytes_written = ::write(client_fd_, buffer.data(), buffer.size());
     if (bytes_written < 0) {
         if (errno == EAGAIN || errno == EWOULDBLOCK) {
-            spdlog::trace("TCP want write");
+            SPDLOG_TRACE("TCP want write");
             return std::unexpected(TransportError::WantReadOrWrite);
         }
         spdlog::error("TCP write error: {}", strerror(errno));
@@ -57,12 +63,38 @@ std::expected<ssize_t, TransportError> TcpTransport::write(std::span<const uint8
         // TODO: Fix this!
         return std::unexpected(TransportError::WriteError);
     }
-    spdlog::trace("successfully wrote {} bytes to TCP socket", bytes_written);
+    SPDLOG_TRACE("successfully wrote {} bytes to TCP socket", bytes_written);
     return bytes_written;
 }
 
+std::expected<ssize_t, TransportError> TcpTransport::send_file(int file_fd, off_t offset,
+                                                             size_t count) const {
+#if defined(__linux__)
+    const auto bytes_sent = ::sendfile(client_fd_, file_fd, &offset, count);
+#else
+    auto len = static_cast<off_t>(count);
+    // on EAGAIN, len still reports the bytes sent before the socket buffer filled
+    const auto result = ::sendfile(file_fd, client_fd_, offset, &len, nullptr, 0);
+    const auto bytes_sent = result == 0 || len > 0 ? static_cast<ssize_t>(len) : ssize_t{-1};
+#endif
+    if (bytes_sent < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            SPDLOG_TRACE("TCP want write (sendfile)");
+            return std::unexpected(TransportError::WantReadOrWrite);
+        }
+        spdlog::error("TCP sendfile error: {}", strerror(errno));
+        return std::unexpected(TransportError::WriteError);
+    }
+    SPDLOG_TRACE("sent {} of {} bytes from file to TCP socket", bytes_sent, count);
+    return bytes_sent;
+}
+
+bool TcpTransport::supports_send_file() const {
+    return true;
+}
+
 void TcpTransport::graceful_shutdown() const {
-    spdlog::debug("shutting down TCP (SHUT_WR)");
+    SPDLOG_DEBUG("shutting down TCP (SHUT_WR)");
     if (shutdown(client_fd_, SHUT_WR) == -1) {
         spdlog::error("shutdown failed: {}", strerror(errno));
     }
@@ -19,6 +19,9 @@ class TcpTransport : public Transport {
 
     std::expected<ssize_t, TransportError> read(std::span<uint8_t> buffer) const override;
     std::expected<ssize_t, TransportError> write(std::span<const uint8_t> buffer) const override;
+    std::expected<ssize_t, TransportError> send_file(int file_fd, off_t offset,
+                                                     size_t count) const override;
+    [[nodiscard]] bool supports_send_file() const override;
     void graceful_shutdown() const override;
     [[nodiscard]] std::expected<void, TransportError> handshake() const override;
 
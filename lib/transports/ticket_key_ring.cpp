@@ -0,0 +1,80 @@
+#include "ticket_key_ring.h"
+
+#include <openssl/crypto.h>
+#include <openssl/rand.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace ion {
+
+template <size_t N>
+static void random_fill(std::array<uint8_t, N>& bytes) {
+    if (RAND_bytes(bytes.data(), static_cast<int>(bytes.size())) != 1) {
+        throw std::runtime_error("failed to generate session ticket key");
+    }
+}
+
+static void cleanse(TicketKey& key) {
+    OPENSSL_cleanse(&key, sizeof(key));
+}
+
+TicketKeyRing::TicketKeyRing(std::chrono::seconds rotation_interval, Clock::time_point now)
+    : rotation_interval_(rotation_interval) {
+    rotate(now);
+    rotations_ = 0;
+}
+
+TicketKeyRing::~TicketKeyRing() {
+    std::ranges::for_each(keys_, cleanse);
+}
+
+void TicketKeyRing::rotate_if_due(Clock::time_point now) {
+    if (now - keys_.front().created >= rotation_interval_) {
+        rotate(now);
+    }
+}
+
+void TicketKeyRing::rotate(Clock::time_point now) {
+    TicketKey key{.created = now};
+    random_fill(key.name);
+    random_fill(key.aes_key);
+    random_fill(key.hmac_key);
+
+    keys_.push_front(key);
+    cleanse(key);
+    while (keys_.size() > MAX_KEYS) {
+        cleanse(keys_.back());
+        keys_.pop_back();
+    }
+    rotations_++;
+    SPDLOG_DEBUG("new session ticket key generated (rotations: {})", rotations_);
+}
+
+const TicketKey& TicketKeyRing::encryption_key(Clock::time_point now) {
+    rotate_if_due(now);
+    return current();
+}
+
+const TicketKey* TicketKeyRing::decryption_key(std::span<const uint8_t, 16> name,
+                                               Clock::time_point now) {
+    rotate_if_due(now);
+    return find(name);
+}
+
+const TicketKey& TicketKeyRing::current() const {
+    return keys_.front();
+}
+
+const TicketKey* TicketKeyRing::find(std::span<const uint8_t, 16> name) const {
+    const auto it = std::ranges::find_if(
+        keys_, [&](const auto& key) { return std::ranges::equal(key.name, name); });
+    return it != keys_.end() ? &*it : nullptr;
+}
+
+uint64_t TicketKeyRing::rotations() const {
+    return rotations_;
+}
+
+}  // namespace ion
@@ -0,0 +1,55 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <span>
+
+namespace ion {
+
+struct TicketKey {
+    std::array<uint8_t, 16> name;
+    std::array<uint8_t, 32> aes_key;
+    std::array<uint8_t, 32> hmac_key;
+    std::chrono::steady_clock::time_point created;
+};
+
+// In-memory session ticket keys. New tickets are always sealed with the newest key; the previous
+// key is kept for one more rotation so tickets issued just before a rotation still resume.
+class TicketKeyRing {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TicketKeyRing(std::chrono::seconds rotation_interval,
+                           Clock::time_point now = Clock::now());
+    ~TicketKeyRing();
+
+    TicketKeyRing(const TicketKeyRing&) = delete;
+    TicketKeyRing& operator=(const TicketKeyRing&) = delete;
+
+    // rotates if the current key is older than the rotation interval
+    void rotate_if_due(Clock::time_point now = Clock::now());
+    void rotate(Clock::time_point now = Clock::now());
+
+    // the key to seal a new ticket with, rotating first if due
+    [[nodiscard]] const TicketKey& encryption_key(Clock::time_point now = Clock::now());
+    // the key a ticket was sealed with, rotating first if due so keys retire on schedule even
+    // when no new tickets are being issued; nullptr if the key has been retired
+    [[nodiscard]] const TicketKey* decryption_key(std::span<const uint8_t, 16> name,
+                                                  Clock::time_point now = Clock::now());
+
+    [[nodiscard]] const TicketKey& current() const;
+    // nullptr if the key has been retired (or never existed)
+    [[nodiscard]] const TicketKey* find(std::span<const uint8_t, 16> name) const;
+    [[nodiscard]] uint64_t rotations() const;
+
+   private:
+    static constexpr size_t MAX_KEYS = 2;
+
+    std::chrono::seconds rotation_interval_;
+    // newest first
+    std::deque<TicketKey> keys_{};
+    uint64_t rotations_{};
+};
+
+}  // namespace ion
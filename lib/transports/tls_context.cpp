@@ -1,5 +1,8 @@
 #include "tls_context.h"
 
+#include <openssl/core_names.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
 #include <spdlog/spdlog.h>
 
 #include <array>
@@ -8,7 +11,7 @@
 namespace ion {
 
 TlsContext::TlsContext(const std::filesystem::path& cert_path,
-                       const std::filesystem::path& key_path) {
+                       const std::filesystem::path& key_path, const TlsOptions& options) {
     if (!exists(cert_path)) {
         throw std::runtime_error("certificate file not found");
     }
@@ -38,6 +41,19 @@ TlsContext::TlsContext(const std::filesystem::path& cert_path,
     }
 
     SSL_CTX_set_alpn_select_cb(ctx_, alpn_callback, nullptr);
+    // free the ~34 KiB of record buffers while a connection is idle
+    SSL_CTX_set_mode(ctx_, SSL_MODE_RELEASE_BUFFERS);
+
+    configure_session_resumption(options);
+
+    if (options.ktls) {
+#if defined(SSL_OP_ENABLE_KTLS)
+        SSL_CTX_set_options(ctx_, SSL_OP_ENABLE_KTLS);
+        spdlog::info("kernel TLS offload requested");
+#else
+        spdlog::warn("kernel TLS offload not supported by this OpenSSL build");
+#endif
+    }
 
     SSL_CTX_set_keylog_callback(ctx_, [](const SSL*, const char* line) {
         if (const auto keylog_file = std::getenv("SSLKEYLOGFILE")) {
@@ -49,6 +65,31 @@ TlsContext::TlsContext(const std::filesystem::path& cert_path,
     });
 }
 
+void TlsContext::configure_session_resumption(const TlsOptions& options) {
+    static constexpr std::string_view SESSION_ID_CONTEXT{"ion"};
+    SSL_CTX_set_session_id_context(
+        ctx_, reinterpret_cast<const unsigned char*>(SESSION_ID_CONTEXT.data()),
+        SESSION_ID_CONTEXT.size());
+
+    if (options.session_cache_size > 0) {
+        SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_SERVER);
+        SSL_CTX_sess_set_cache_size(ctx_, static_cast<long>(options.session_cache_size));
+    } else {
+        SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_OFF);
+    }
+
+    if (!options.session_tickets) {
+        SSL_CTX_set_options(ctx_, SSL_OP_NO_TICKET);
+        return;
+    }
+
+    // a ticket is accepted for at most two rotations: while its key is current and previous
+    SSL_CTX_set_timeout(ctx_, static_cast<long>(options.ticket_key_rotation.count()) * 2);
+    ticket_keys_.emplace(options.ticket_key_rotation);
+    SSL_CTX_set_app_data(ctx_, this);
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx_, ticket_key_callback);
+}
+
 TlsContext::~TlsContext() {
     if (ctx_) {
         SSL_CTX_free(ctx_);
@@ -63,6 +104,58 @@ SSL* TlsContext::create_ssl() const {
     return ssl;
 }
 
+void TlsContext::record_handshake(bool resumed) const {
+    (resumed ? resumed_handshakes_ : full_handshakes_).fetch_add(1, std::memory_order_relaxed);
+}
+
+TlsHandshakeStats TlsContext::handshake_stats() const {
+    return {.full = full_handshakes_.load(std::memory_order_relaxed),
+            .resumed = resumed_handshakes_.load(std::memory_order_relaxed)};
+}
+
+int TlsContext::ticket_key_callback(SSL* ssl, unsigned char* key_name, unsigned char* iv,
+                                    EVP_CIPHER_CTX* cipher_ctx, EVP_MAC_CTX* mac_ctx,
+                                    int encrypt) {
+    auto* self = static_cast<TlsContext*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+    std::lock_guard lock{self->ticket_keys_mutex_};
+    auto& keys = *self->ticket_keys_;
+
+    const TicketKey* key{};
+    if (encrypt) {
+        key = &keys.encryption_key();
+        std::ranges::copy(key->name, key_name);
+        if (RAND_bytes(iv, EVP_CIPHER_get_iv_length(EVP_aes_256_cbc())) != 1) {
+            return -1;
+        }
+    } else {
+        // rotating here too retires keys on time when clients only resume (TLS 1.2 resumption
+        // under the current key doesn't issue a new ticket)
+        key = keys.decryption_key(std::span<const uint8_t, 16>{key_name, 16});
+        if (!key) {
+            SPDLOG_DEBUG("session ticket key retired, doing full handshake");
+            return 0;
+        }
+    }
+
+    std::array params{
+        OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY,
+                                          const_cast<uint8_t*>(key->hmac_key.data()),
+                                          key->hmac_key.size()),
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char*>("SHA256"), 0),
+        OSSL_PARAM_construct_end(),
+    };
+    if (EVP_MAC_CTX_set_params(mac_ctx, params.data()) != 1) {
+        return -1;
+    }
+
+    const auto init = encrypt ? EVP_EncryptInit_ex : EVP_DecryptInit_ex;
+    if (init(cipher_ctx, EVP_aes_256_cbc(), nullptr, key->aes_key.data(), iv) != 1) {
+        return -1;
+    }
+    // 2 asks OpenSSL to issue a fresh ticket under the current key
+    return encrypt || key == &keys.current() ? 1 : 2;
+}
+
 // ReSharper disable once CppDFAConstantFunctionResult
 int TlsContext::alpn_callback(SSL*, const unsigned char** out, unsigned char* outlen,
                               const unsigned char* in, unsigned int inlen, void*) {
@@ -72,15 +165,15 @@ int TlsContext::alpn_callback(SSL*, const unsigned char** out, unsigned char* ou
         SSL_select_next_proto(const_cast<unsigned char**>(out), outlen, supported_protos.data(),
                               supported_protos.size(), in, inlen);
     if (result == OPENSSL_NPN_NEGOTIATED) {
-        spdlog::debug("ALPN negotiated: {}",
-                      std::string(reinterpret_cast<const char*>(*out), *outlen));
+        SPDLOG_DEBUG("ALPN negotiated: {}",
+                     std::string(reinterpret_cast<const char*>(*out), *outlen));
         return SSL_TLSEXT_ERR_OK;
     }
 
     *outlen = supported_protos[0];
     *out = supported_protos.data() + 1;
-    spdlog::debug("ALPN negotiation failed, using default: {}",
-                  std::string(reinterpret_cast<const char*>(*out), *outlen));
+    SPDLOG_DEBUG("ALPN negotiation failed, using default: {}",
+                 std::string(reinterpret_cast<const char*>(*out), *outlen));
     return SSL_TLSEXT_ERR_OK;
 }
 
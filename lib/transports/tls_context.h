@@ -2,15 +2,42 @@
 
 #include <openssl/ssl.h>
 
+#include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <mutex>
+#include <optional>
+
+#include "ticket_key_ring.h"
 
 namespace ion {
 
+struct TlsOptions {
+    // let the kernel take over the record layer after the handshake (kTLS) so responses can be
+    // written with sendfile. Falls back to user space TLS if the kernel, OpenSSL build or
+    // negotiated cipher doesn't support it
+    bool ktls{};
+    // stateless resumption (RFC 8446 / RFC 5077 tickets) with keys held only in memory and
+    // replaced every ticket_key_rotation
+    bool session_tickets{true};
+    std::chrono::seconds ticket_key_rotation{std::chrono::hours{1}};
+    // server-side session cache entries for clients that don't use tickets (0 disables)
+    size_t session_cache_size{};
+};
+
+struct TlsHandshakeStats {
+    uint64_t full;
+    uint64_t resumed;
+};
+
 class TlsContext {
    public:
-    TlsContext(const std::filesystem::path& cert_path, const std::filesystem::path& key_path);
+    TlsContext(const std::filesystem::path& cert_path, const std::filesystem::path& key_path,
+               const TlsOptions& options = {});
     ~TlsContext();
     [[nodiscard]] SSL* create_ssl() const;
+    void record_handshake(bool resumed) const;
+    [[nodiscard]] TlsHandshakeStats handshake_stats() const;
 
     TlsContext(const TlsContext&) = delete;
     TlsContext& operator=(const TlsContext&) = delete;
@@ -19,9 +46,18 @@ class TlsContext {
 
    private:
     SSL_CTX* ctx_{};
+    std::optional<TicketKeyRing> ticket_keys_{};
+    // handshakes may run concurrently on HandshakePool workers
+    std::mutex ticket_keys_mutex_{};
+    mutable std::atomic<uint64_t> full_handshakes_{};
+    mutable std::atomic<uint64_t> resumed_handshakes_{};
+
+    void configure_session_resumption(const TlsOptions& options);
 
     static int alpn_callback(SSL* ssl, const unsigned char** out, unsigned char* outlen,
                              const unsigned char* in, unsigned int inlen, void* arg);
+    static int ticket_key_callback(SSL* ssl, unsigned char* key_name, unsigned char* iv,
+                                   EVP_CIPHER_CTX* cipher_ctx, EVP_MAC_CTX* mac_ctx, int encrypt);
 };
 
 }  // namespace ion
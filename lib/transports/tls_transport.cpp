@@ -13,7 +13,10 @@
 namespace ion {
 
 TlsTransport::TlsTransport(TlsTransport&& other) noexcept
-    : client_fd_(std::move(other.client_fd_)), ssl_(std::exchange(other.ssl_, nullptr)) {}
+    : client_fd_(std::move(other.client_fd_)),
+      tls_context_(other.tls_context_),
+      ssl_(std::exchange(other.ssl_, nullptr)),
+      ktls_send_(other.ktls_send_) {}
 
 TlsTransport& TlsTransport::operator=(TlsTransport&& other) noexcept {
     if (this == &other) {
@@ -24,12 +27,14 @@ TlsTransport& TlsTransport::operator=(TlsTransport&& other) noexcept {
         ssl_ = nullptr;
     }
     client_fd_ = std::move(other.client_fd_);
+    tls_context_ = other.tls_context_;
     ssl_ = std::exchange(other.ssl_, nullptr);
+    ktls_send_ = other.ktls_send_;
     return *this;
 }
 
 TlsTransport::TlsTransport(SocketFd&& client_fd, const TlsContext& tls_context)
-    : client_fd_(std::move(client_fd)) {
+    : client_fd_(std::move(client_fd)), tls_context_(&tls_context) {
     ssl_ = tls_context.create_ssl();
 
     if (SSL_set_fd(ssl_, client_fd_) != 1) {
@@ -40,16 +45,21 @@ TlsTransport::TlsTransport(SocketFd&& client_fd, const TlsContext& tls_context)
 std::expected<void, TransportError> TlsTransport::handshake() const {
     const int result = SSL_accept(ssl_);
     if (result == 1) {
+        ktls_send_ = BIO_get_ktls_send(SSL_get_wbio(ssl_)) == 1;
+        const bool resumed = SSL_session_reused(ssl_) == 1;
+        tls_context_->record_handshake(resumed);
+        SPDLOG_DEBUG("TLS handshake complete ({}, {}, resumed: {}, kTLS send: {})",
+                     SSL_get_version(ssl_), SSL_get_cipher_name(ssl_), resumed, ktls_send_);
         return {};
     }
 
     switch (const int ssl_error = SSL_get_error(ssl_, result)) {
         case SSL_ERROR_ZERO_RETURN:
-            spdlog::debug("TLS connection closed by peer before handshake (likely health check)");
+            SPDLOG_DEBUG("TLS connection closed by peer before handshake (likely health check)");
             return std::unexpected(TransportError::ConnectionClosed);
         case SSL_ERROR_WANT_READ:
         case SSL_ERROR_WANT_WRITE: {
-            spdlog::trace("TLS handshake want read/write");
+            SPDLOG_TRACE("TLS handshake want read/write");
             return std::unexpected(TransportError::WantReadOrWrite);
         }
         case SSL_ERROR_SSL: {
@@ -71,7 +81,7 @@ std::expected<void, TransportError> TlsTransport::handshake() const {
 
 TlsTransport::~TlsTransport() {
     if (ssl_) {
-        spdlog::debug("freeing OpenSSL");
+        SPDLOG_DEBUG("freeing OpenSSL");
         SSL_free(ssl_);
         ssl_ = nullptr;
     }
@@ -80,9 +90,9 @@ TlsTransport::~TlsTransport() {
 void TlsTransport::graceful_shutdown() const {
     BIO_flush(SSL_get_wbio(ssl_));
     // Bidirectional shutdown
-    spdlog::debug("shutting down SSL (client notify)");
+    SPDLOG_DEBUG("shutting down SSL (client notify)");
     if (const int ret = SSL_shutdown(ssl_); ret == 0) {
-        spdlog::debug("shutting down SSL (force)");
+        SPDLOG_DEBUG("shutting down SSL (force)");
         SSL_shutdown(ssl_);
     }
 }
@@ -92,18 +102,21 @@ void TlsTransport::print_debug_to_stderr() {
 }
 
 std::expected<ssize_t, TransportError> TlsTransport::read(std::span<uint8_t> buffer) const {
-    spdlog::trace("reading from SSL");
+    SPDLOG_TRACE("reading from SSL");
+    // SSL_get_error reads the thread's error queue, which must be empty before each call. Only
+    // SSL_accept clears it itself, and that may now run on another thread (HandshakePool)
+    ERR_clear_error();
     const auto bytes_read = SSL_read(ssl_, buffer.data(), static_cast<int>(buffer.size()));
     if (bytes_read <= 0) {
         switch (const int ssl_error = SSL_get_error(ssl_, bytes_read)) {
             case SSL_ERROR_WANT_READ:
-                spdlog::trace("SSL want read");
+                SPDLOG_TRACE("SSL want read");
                 return std::unexpected(TransportError::WantReadOrWrite);
             case SSL_ERROR_WANT_WRITE:
-                spdlog::trace("SSL want write");
+                SPDLOG_TRACE("SSL want write");
                 return std::unexpected(TransportError::WantReadOrWrite);
             case SSL_ERROR_ZERO_RETURN:
-                spdlog::debug("TLS connection closed");
+                SPDLOG_DEBUG("TLS connection closed");
                 return std::unexpected(TransportError::ConnectionClosed);
             case SSL_ERROR_SSL:
                 spdlog::error("TLS protocol error (SSL_ERROR_SSL)");
@@ -113,22 +126,23 @@ std::expected<ssize_t, TransportError> TlsTransport::read(std::span<uint8_t> buf
                 return std::unexpected(TransportError::OtherError);
         }
     }
-    spdlog::trace("successfully read {} bytes from SSL", bytes_read);
+    SPDLOG_TRACE("successfully read {} bytes from SSL", bytes_read);
     return bytes_read;
 }
 
 std::expected<ssize_t, TransportError> TlsTransport::write(std::span<const uint8_t> buffer) const {
+    ERR_clear_error();
     const auto bytes_written = SSL_write(ssl_, buffer.data(), static_cast<int>(buffer.size()));
     if (bytes_written < 0) {
         switch (const int ssl_error = SSL_get_error(ssl_, bytes_written)) {
             case SSL_ERROR_WANT_READ:
-                spdlog::trace("SSL want read");
+                SPDLOG_TRACE("SSL want read");
                 return std::unexpected(TransportError::WantReadOrWrite);
             case SSL_ERROR_WANT_WRITE:
-                spdlog::trace("SSL want write");
+                SPDLOG_TRACE("SSL want write");
                 return std::unexpected(TransportError::WantReadOrWrite);
             case SSL_ERROR_ZERO_RETURN:
-                spdlog::debug("TLS connection closed");
+                SPDLOG_DEBUG("TLS connection closed");
                 return std::unexpected(TransportError::ConnectionClosed);
             case SSL_ERROR_SSL:
                 spdlog::error("TLS protocol error (SSL_ERROR_SSL)");
@@ -142,8 +156,31 @@ std::expected<ssize_t, TransportError> TlsTransport::write(std::span<const uint8
         spdlog::error("SSL partial write: wrote {} of {} bytes", bytes_written, buffer.size());
         return std::unexpected(TransportError::WriteError);
     }
-    spdlog::trace("successfully wrote {} bytes to SSL", bytes_written);
+    SPDLOG_TRACE("successfully wrote {} bytes to SSL", bytes_written);
     return bytes_written;
 }
 
+std::expected<ssize_t, TransportError> TlsTransport::send_file(int file_fd, off_t offset,
+                                                             size_t count) const {
+    ERR_clear_error();
+    const auto bytes_sent = SSL_sendfile(ssl_, file_fd, offset, count, 0);
+    if (bytes_sent < 0) {
+        switch (const int ssl_error = SSL_get_error(ssl_, static_cast<int>(bytes_sent))) {
+            case SSL_ERROR_WANT_READ:
+            case SSL_ERROR_WANT_WRITE:
+                SPDLOG_TRACE("SSL want read/write (sendfile)");
+                return std::unexpected(TransportError::WantReadOrWrite);
+            default:
+                spdlog::error("TLS sendfile error (SSL_ERROR={})", ssl_error);
+                return std::unexpected(TransportError::WriteError);
+        }
+    }
+    SPDLOG_TRACE("sent {} of {} bytes from file over kTLS", bytes_sent, count);
+    return bytes_sent;
+}
+
+bool TlsTransport::supports_send_file() const {
+    return ktls_send_;
+}
+
 }  // namespace ion
@@ -25,12 +25,18 @@ class TlsTransport : public Transport {
     static void print_debug_to_stderr();
     std::expected<ssize_t, TransportError> read(std::span<uint8_t> buffer) const override;
     std::expected<ssize_t, TransportError> write(std::span<const uint8_t> buffer) const override;
+    std::expected<ssize_t, TransportError> send_file(int file_fd, off_t offset,
+                                                     size_t count) const override;
+    // true once the handshake has completed with kTLS handling the send side
+    [[nodiscard]] bool supports_send_file() const override;
     [[nodiscard]] std::expected<void, TransportError> handshake() const override;
     void graceful_shutdown() const override;
 
    private:
     SocketFd client_fd_;
+    const TlsContext* tls_context_;
     SSL* ssl_ = nullptr;
+    mutable bool ktls_send_{};
 };
 
 }  // namespace ion
@@ -1,4 +1,5 @@
 #pragma once
+#include <sys/types.h>
 #include <unistd.h>
 
 #include <expected>
@@ -20,6 +21,15 @@ class Transport {
 
     virtual std::expected<ssize_t, TransportError> read(std::span<uint8_t> buffer) const = 0;
     virtual std::expected<ssize_t, TransportError> write(std::span<const uint8_t> buffer) const = 0;
+    // writes up to count bytes of file_fd from offset without copying them through user space;
+    // may write fewer bytes than requested. Only called when supports_send_file()
+    virtual std::expected<ssize_t, TransportError> send_file(int /*file_fd*/, off_t /*offset*/,
+                                                             size_t /*count*/) const {
+        return std::unexpected(TransportError::OtherError);
+    }
+    [[nodiscard]] virtual bool supports_send_file() const {
+        return false;
+    }
     virtual void graceful_shutdown() const = 0;
     [[nodiscard]] virtual std::expected<void, TransportError> handshake() const = 0;
 };
@@ -4,7 +4,7 @@
 
 #include "spdlog/spdlog.h"
 
-ion::Http2Server TestHelpers::create_test_server() {
+ion::Http2Server TestHelpers::create_test_server(const ion::TlsOptions& tls) {
     spdlog::set_level(spdlog::level::err);
 
     const char* cert_env = std::getenv("ION_TLS_CERT_PATH");
@@ -13,6 +13,7 @@ ion::Http2Server TestHelpers::create_test_server() {
     const auto config = ion::ServerConfiguration{
         .cert_path = cert_env ? std::optional{std::filesystem::path{cert_env}} : std::nullopt,
         .key_path = key_env ? std::optional{std::filesystem::path{key_env}} : std::nullopt,
+        .tls = tls,
     };
 
     config.validate();
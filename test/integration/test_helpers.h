@@ -4,5 +4,5 @@
 
 class TestHelpers {
    public:
-    static ion::Http2Server create_test_server();
+    static ion::Http2Server create_test_server(const ion::TlsOptions& tls = {});
 };
@@ -61,8 +61,9 @@ TEST_CASE("server: returns custom headers") {
     CurlClient client;
     const auto res = client.get(std::format("https://localhost:{}/hdrs", TEST_PORT));
     REQUIRE(res.status_code == 200);
-    REQUIRE(res.headers.size() == 3);
+    REQUIRE(res.headers.size() == 4);
     REQUIRE(res.headers.at("x-foo") == "bar");
+    REQUIRE(res.headers.contains("date"));
 }
 
 TEST_CASE("server: returns body") {
@@ -110,3 +110,18 @@ TEST_CASE("static: middleware support") {
         REQUIRE(res.status_code == 202);
     }
 }
+
+TEST_CASE("static: streams uncached files with kTLS requested") {
+    // served with SSL_sendfile if the kernel supports kTLS, otherwise through SSL_write
+    auto server = TestHelpers::create_test_server({.ktls = true});
+
+    server.router().add_static_handler(std::make_unique<ion::StaticFileHandler>(
+        "/static", "./test/system/static", ion::StaticFileCacheConfig{.max_bytes = 0}));
+
+    TestServerRunner run(server, TEST_PORT);
+
+    CurlClient client;
+    const auto res = client.get(std::format("https://localhost:{}/static/index.html", TEST_PORT));
+    REQUIRE(res.status_code == 200);
+    CHECK(res.body.find("Hello from static") != std::string::npos);
+}
@@ -18,6 +18,7 @@ SERVER_H2C_PORT = 8080
 
 BASE_URL = f"https://localhost:{SERVER_PORT}"
 OK_URL = BASE_URL + "/_tests/ok"
+LOG_URL = BASE_URL + "/_tests/log"
 SECURITY_URL = BASE_URL + "/_tests/no_new_privs"
 
 
@@ -3,6 +3,7 @@ import httpx
 import pytest
 import logging
 import os
+import re
 
 logging.basicConfig(
     format="%(levelname)s [%(asctime)s] %(name)s - %(message)s",
@@ -149,3 +150,20 @@ async def test_httpx_status_page_shows_server_status(ion_server):
     assert response.status_code == 200
     assert response.headers["content-type"] == "text/html; charset=utf-8"
     assert response.headers["cache-control"] == "no-store"
+    assert "p99 / p99.9" in response.text
+
+
+@pytest.mark.asyncio
+@pytest.mark.parametrize("ion_server", [["--metrics-page"]], indirect=True)
+async def test_httpx_metrics_page_exposes_prometheus_metrics(ion_server):
+    client = httpx.AsyncClient(http2=True, verify=False)
+    assert (await client.get(OK_URL)).status_code == 200
+    response = await client.get(BASE_URL + "/_ion/metrics")
+
+    assert response.status_code == 200
+    assert response.headers["content-type"] == "text/plain; version=0.0.4; charset=utf-8"
+    assert "# TYPE ion_http_requests_total counter" in response.text
+    assert 'ion_http_requests_total{code="200"} 1' in response.text
+    assert 'ion_http_request_duration_seconds_bucket{le="+Inf"} 1' in response.text
+    assert re.search(r"^ion_connections_active [1-9]", response.text, re.MULTILINE)
+    assert "ion_tls_handshakes_total" in response.text
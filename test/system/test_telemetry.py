@@ -3,17 +3,20 @@ import httpx
 import asyncio
 import re
 from aiohttp import web
-from helpers.utils import OK_URL
+from helpers.utils import OK_URL, LOG_URL
 
 OTLP_TRACES_PATH = "/v1/traces"
+OTLP_METRICS_PATH = "/v1/metrics"
 MOCK_COLLECTOR_PORT = 43180
 
 
 class MockOTLPCollector:
     def __init__(self):
         self.received_payloads = []
+        self.received_metrics = []
         self.app = web.Application()
         self.app.router.add_post(OTLP_TRACES_PATH, self.handle_traces)
+        self.app.router.add_post(OTLP_METRICS_PATH, self.handle_metrics)
         self.runner = None
 
     async def handle_traces(self, request):
@@ -22,6 +25,11 @@ class MockOTLPCollector:
         self.received_payloads.append(body)
         return web.Response(status=200)
 
+    async def handle_metrics(self, request):
+        body = await request.read()
+        self.received_metrics.append(body)
+        return web.Response(status=200)
+
     async def start(self):
         print(f"Starting mock OTLP collector on port {MOCK_COLLECTOR_PORT}")
         self.runner = web.AppRunner(self.app)
@@ -62,6 +70,142 @@ async def test_ion_exports_otlp_traces(ion_server):
         await collector.stop()
 
 
+@pytest.mark.asyncio
+@pytest.mark.parametrize("ion_server", [{
+    "env": {
+        "OTEL_EXPORTER_OTLP_ENDPOINT": f"http://localhost:{MOCK_COLLECTOR_PORT}",
+        "OTEL_BSP_SCHEDULE_DELAY": "200"
+    }
+}], indirect=True)
+async def test_ion_exports_spans_in_batches(ion_server):
+    collector = MockOTLPCollector()
+    await collector.start()
+    try:
+        client = httpx.AsyncClient(http2=True, verify=False)
+        for _ in range(20):
+            resp = await client.get(OK_URL)
+            assert resp.status_code == 200
+
+        await asyncio.sleep(0.5)
+
+        all_data = b"".join(collector.received_payloads)
+        assert all_data.count(b"http_request") == 20
+        assert 0 < len(collector.received_payloads) < 20
+
+    finally:
+        await collector.stop()
+
+
+@pytest.mark.asyncio
+@pytest.mark.parametrize("ion_server", [{
+    "env": {
+        "OTEL_EXPORTER_OTLP_ENDPOINT": f"http://localhost:{MOCK_COLLECTOR_PORT}",
+        "OTEL_BSP_SCHEDULE_DELAY": "10"
+    },
+    "extra_args": ["--trace-sample-ratio", "0"]
+}], indirect=True)
+async def test_ion_exports_no_spans_when_unsampled(ion_server):
+    collector = MockOTLPCollector()
+    await collector.start()
+    try:
+        client = httpx.AsyncClient(http2=True, verify=False)
+        resp = await client.get(OK_URL)
+        assert resp.status_code == 200
+
+        await asyncio.sleep(0.1)
+
+        assert b"http_request" not in b"".join(collector.received_payloads)
+
+    finally:
+        await collector.stop()
+
+
+@pytest.mark.asyncio
+@pytest.mark.parametrize("ion_server", [{
+    "env": {
+        "OTEL_EXPORTER_OTLP_ENDPOINT": f"http://localhost:{MOCK_COLLECTOR_PORT}",
+        "OTEL_METRIC_EXPORT_INTERVAL": "100"
+    }
+}], indirect=True)
+async def test_ion_exports_otlp_metrics(ion_server):
+    collector = MockOTLPCollector()
+    await collector.start()
+    try:
+        client = httpx.AsyncClient(http2=True, verify=False)
+        resp = await client.get(OK_URL)
+        assert resp.status_code == 200
+
+        await asyncio.sleep(0.5)
+
+        all_data = b"".join(collector.received_metrics)
+        assert b"http.server.request.duration" in all_data
+        assert b"http.route" in all_data
+        assert b"ion.connections.active" in all_data
+        assert b"ion.bytes.sent" in all_data
+        assert b"ion.hpack.encoder.table.size" in all_data
+
+    finally:
+        await collector.stop()
+
+
+TRACE_ID = "4bf92f3577b34da6a3ce929d0e0e4736"
+PARENT_SPAN_ID = "00f067aa0ba902b7"
+
+
+@pytest.mark.asyncio
+@pytest.mark.parametrize("ion_server", [{
+    "env": {
+        "OTEL_EXPORTER_OTLP_ENDPOINT": f"http://localhost:{MOCK_COLLECTOR_PORT}",
+        "OTEL_BSP_SCHEDULE_DELAY": "10"
+    },
+    "extra_args": ["--trace-sample-ratio", "0"]
+}], indirect=True)
+async def test_ion_follows_sampled_traceparent(ion_server):
+    collector = MockOTLPCollector()
+    await collector.start()
+    try:
+        client = httpx.AsyncClient(http2=True, verify=False)
+        resp = await client.get(OK_URL, headers={
+            "traceparent": f"00-{TRACE_ID}-{PARENT_SPAN_ID}-01",
+        })
+        assert resp.status_code == 200
+
+        await asyncio.sleep(0.1)
+
+        all_data = b"".join(collector.received_payloads)
+        assert b"http_request" in all_data
+        assert bytes.fromhex(TRACE_ID) in all_data
+        assert bytes.fromhex(PARENT_SPAN_ID) in all_data
+
+    finally:
+        await collector.stop()
+
+
+@pytest.mark.asyncio
+@pytest.mark.parametrize("ion_server", [{
+    "env": {
+        "OTEL_EXPORTER_OTLP_ENDPOINT": f"http://localhost:{MOCK_COLLECTOR_PORT}",
+        "OTEL_BSP_SCHEDULE_DELAY": "10"
+    }
+}], indirect=True)
+async def test_ion_follows_unsampled_traceparent(ion_server):
+    collector = MockOTLPCollector()
+    await collector.start()
+    try:
+        client = httpx.AsyncClient(http2=True, verify=False)
+        resp = await client.get(OK_URL, headers={
+            "traceparent": f"00-{TRACE_ID}-{PARENT_SPAN_ID}-00",
+        })
+        assert resp.status_code == 200
+
+        await asyncio.sleep(0.1)
+
+        assert b"http_request" not in b"".join(collector.received_payloads)
+
+    finally:
+        await collector.stop()
+
+
 @pytest.mark.asyncio
 @pytest.mark.parametrize("ion_server", [{
     "env": {
@@ -84,7 +228,7 @@ async def test_telemetry_silent_when_collector_unavailable(ion_server):
 @pytest.mark.asyncio
 async def test_trace_id_appears_in_logs(ion_server):
     client = httpx.AsyncClient(http2=True, verify=False)
-    resp = await client.get(OK_URL)
+    resp = await client.get(LOG_URL)
     assert resp.status_code == 200
     await asyncio.sleep(0.1)
     await ion_server.stop()
@@ -97,7 +241,7 @@ async def test_trace_id_appears_in_logs(ion_server):
     # \[.*?\]             -> The level: [%l]
     # \s+                 -> space
     # \[([a-f0-9]{32})\]  -> The Trace ID: [%J] (capturing group for 32 hex chars)
-    trace_id_pattern = re.compile(r"\[.*?\]\s+\[.*?\]\s+\[([a-f0-9]{32})\]\s+received HEADERS frame")
+    trace_id_pattern = re.compile(r"\[.*?\]\s+\[.*?\]\s+\[([a-f0-9]{32})\]\s+test route handled")
 
     matches = trace_id_pattern.findall(stdout)
     assert len(matches) > 0
@@ -365,3 +365,87 @@ TEST_CASE("headers: dynamic table management") {
         REQUIRE(res.error() == FrameError::ProtocolError);
     }
 }
+
+TEST_CASE("headers: rejects malformed fields") {
+    auto dynamic_table = ion::DynamicTable{};
+    auto decoder = ion::HeaderBlockDecoder{dynamic_table};
+
+    SECTION ("uppercase name") {
+        // literal without indexing, new name "X-Foo", value "bar"
+        constexpr auto data =
+            std::to_array<uint8_t>({0x00, 0x05, 'X', '-', 'F', 'o', 'o', 0x03, 'b', 'a', 'r'});
+        auto res = decoder.decode(data);
+
+        REQUIRE(!res);
+        REQUIRE(res.error() == FrameError::ProtocolError);
+    }
+
+    SECTION ("CRLF in value") {
+        // literal with incremental indexing, indexed name "user-agent"
+        constexpr auto data = std::to_array<uint8_t>({0x7a, 0x04, 'a', '\r', '\n', 'b'});
+        auto res = decoder.decode(data);
+
+        REQUIRE(!res);
+        REQUIRE(res.error() == FrameError::ProtocolError);
+        REQUIRE(dynamic_table.count() == 0);
+    }
+}
+
+TEST_CASE("headers: captures request pseudo-headers") {
+    auto dynamic_table = ion::DynamicTable{};
+    auto decoder = ion::HeaderBlockDecoder{dynamic_table};
+    auto encoder_table = ion::DynamicTable{};
+    auto encoder = ion::HeaderBlockEncoder{encoder_table};
+    auto pseudo = ion::RequestPseudoHeaders{};
+
+    SECTION ("moves pseudo-headers into typed fields") {
+        const auto block = encoder.encode({{":method", "HEAD"},
+                                           {":scheme", "https"},
+                                           {":authority", "localhost"},
+                                           {":path", "/index.html"},
+                                           {"user-agent", "test"}});
+        auto hdrs = decoder.decode(block, pseudo);
+
+        REQUIRE(hdrs);
+        REQUIRE(pseudo.method == ion::HttpMethod::Head);
+        REQUIRE(pseudo.method_name == "HEAD");
+        REQUIRE(pseudo.scheme == "https");
+        REQUIRE(pseudo.authority == "localhost");
+        REQUIRE(pseudo.path == "/index.html");
+        REQUIRE(hdrs->size() == 1);
+        check_header(*hdrs, 0, "user-agent", "test");
+    }
+
+    SECTION ("keeps extension method names") {
+        const auto block = encoder.encode({{":method", "PROPFIND"}, {":path", "/"}});
+        auto hdrs = decoder.decode(block, pseudo);
+
+        REQUIRE(hdrs);
+        REQUIRE(pseudo.method == ion::HttpMethod::Other);
+        REQUIRE(pseudo.method_name == "PROPFIND");
+    }
+
+    SECTION ("rejects pseudo-headers after regular fields") {
+        const auto block = encoder.encode({{"user-agent", "test"}, {":path", "/"}});
+        auto res = decoder.decode(block, pseudo);
+
+        REQUIRE(!res);
+        REQUIRE(res.error() == FrameError::ProtocolError);
+    }
+
+    SECTION ("rejects duplicate pseudo-headers") {
+        const auto block = encoder.encode({{":path", "/"}, {":path", "/other"}});
+        auto res = decoder.decode(block, pseudo);
+
+        REQUIRE(!res);
+        REQUIRE(res.error() == FrameError::ProtocolError);
+    }
+
+    SECTION ("rejects response pseudo-headers in requests") {
+        const auto block = encoder.encode({{":status", "200"}});
+        auto res = decoder.decode(block, pseudo);
+
+        REQUIRE(!res);
+        REQUIRE(res.error() == FrameError::ProtocolError);
+    }
+}
@@ -2,6 +2,7 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "catch2/matchers/catch_matchers.hpp"
+#include "hpack/header_block_decoder.h"
 #include "hpack/header_block_encoder.h"
 #include "http2_frames.h"
 
@@ -83,3 +84,87 @@ TEST_CASE("headers: encodes dynamic table entries") {
         REQUIRE(bytes2 == std::vector<uint8_t>{0x7e, 0x03, 0x62, 0x61, 0x7a});
     }
 }
+
+TEST_CASE("headers: pre-encodes headers without touching the dynamic table") {
+    auto dynamic_table = ion::DynamicTable{};
+    auto encoder = ion::HeaderBlockEncoder{dynamic_table};
+
+    SECTION ("static table entry is indexed") {
+        const auto pre_encoded = ion::HeaderBlockEncoder::pre_encode({{":status", "200"}});
+
+        REQUIRE(pre_encoded.bytes == std::vector<uint8_t>{0x88});
+    }
+
+    SECTION ("static header name is a literal without indexing") {
+        const auto pre_encoded = ion::HeaderBlockEncoder::pre_encode({{"server", "ion"}});
+
+        REQUIRE(pre_encoded.bytes == std::vector<uint8_t>{0x0f, 0x27, 0x03, 0x69, 0x6f, 0x6e});
+    }
+
+    SECTION ("new header name is a literal without indexing") {
+        const auto pre_encoded = ion::HeaderBlockEncoder::pre_encode({{"x-a", "b"}});
+
+        REQUIRE(pre_encoded.bytes ==
+                std::vector<uint8_t>{0x00, 0x03, 0x78, 0x2d, 0x61, 0x01, 0x62});
+    }
+
+    SECTION ("splices fragments after dynamically encoded headers") {
+        const auto server = ion::HeaderBlockEncoder::pre_encode({{"server", "ion"}});
+
+        auto bytes = encoder.encode({{":status", "200"}}, {nullptr, &server});
+
+        REQUIRE(bytes == std::vector<uint8_t>{0x88, 0x0f, 0x27, 0x03, 0x69, 0x6f, 0x6e});
+        REQUIRE(dynamic_table.count() == 0);
+    }
+
+    SECTION ("fragment decodes to the original headers") {
+        const auto pre_encoded = ion::HeaderBlockEncoder::pre_encode({
+            {"content-type", "text/html; charset=utf-8"},
+            {"x-powered-by", "ion"},
+        });
+
+        auto decoder_table = ion::DynamicTable{};
+        auto decoder = ion::HeaderBlockDecoder{decoder_table};
+        auto hdrs = decoder.decode(pre_encoded.bytes);
+
+        REQUIRE(hdrs);
+        REQUIRE(hdrs->size() == 2);
+        REQUIRE((*hdrs)[0].name == "content-type");
+        REQUIRE((*hdrs)[0].value == "text/html; charset=utf-8");
+        REQUIRE((*hdrs)[1].name == "x-powered-by");
+        REQUIRE((*hdrs)[1].value == "ion");
+        REQUIRE(decoder_table.count() == 0);
+    }
+}
+
+TEST_CASE("headers: applies indexing policy to literals") {
+    auto dynamic_table = ion::DynamicTable{};
+    auto encoder = ion::HeaderBlockEncoder{dynamic_table};
+
+    SECTION ("volatile header is a literal without indexing") {
+        auto bytes = encoder.encode({{"content-length", "123"}});
+
+        REQUIRE(bytes == std::vector<uint8_t>{0x0f, 0x0d, 0x03, 0x31, 0x32, 0x33});
+        REQUIRE(dynamic_table.count() == 0);
+    }
+
+    SECTION ("sensitive header is a literal never indexed") {
+        auto bytes = encoder.encode({{"set-cookie", "a=b"}});
+
+        REQUIRE(bytes == std::vector<uint8_t>{0x1f, 0x28, 0x03, 0x61, 0x3d, 0x62});
+        REQUIRE(dynamic_table.count() == 0);
+    }
+
+    SECTION ("header with changing values stops being indexed") {
+        auto config = ion::IndexingPolicyConfig{.min_samples = 2};
+        auto learning_encoder = ion::HeaderBlockEncoder{dynamic_table, config};
+
+        learning_encoder.encode({{"x-id", "1"}});
+        learning_encoder.encode({{"x-id", "2"}});
+        REQUIRE(dynamic_table.count() == 2);
+
+        auto bytes = learning_encoder.encode({{"x-id", "3"}});
+        REQUIRE(bytes[0] == 0x0f);  // literal without indexing, dynamic name index 62
+        REQUIRE(dynamic_table.count() == 2);
+    }
+}
@@ -0,0 +1,65 @@
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+#include "hpack/header_validator.h"
+
+// lengths either side of the 16 and 32 byte vector widths so both the wide and tail paths run
+static constexpr auto LENGTHS = {1, 15, 16, 17, 31, 32, 33, 70};
+
+TEST_CASE("header validator: names") {
+    SECTION ("accepts lowercase tokens and pseudo-headers") {
+        REQUIRE(ion::HeaderValidator::is_valid_name("content-type"));
+        REQUIRE(ion::HeaderValidator::is_valid_name("x-a_b.c!#$%&'*+^`|~09"));
+        REQUIRE(ion::HeaderValidator::is_valid_name(":authority"));
+    }
+
+    SECTION ("rejects empty names") {
+        REQUIRE_FALSE(ion::HeaderValidator::is_valid_name(""));
+        REQUIRE_FALSE(ion::HeaderValidator::is_valid_name(":"));
+    }
+
+    SECTION ("only allows a colon as the first character") {
+        REQUIRE_FALSE(ion::HeaderValidator::is_valid_name("a:b"));
+        REQUIRE_FALSE(ion::HeaderValidator::is_valid_name("::path"));
+    }
+
+    SECTION ("rejects invalid characters at any position") {
+        for (const char bad : {'A', 'Z', ' ', '\0', '\x7f', '\x80', '\xff', '"', '(', '@'}) {
+            for (const int len : LENGTHS) {
+                for (int pos = 0; pos < len; pos++) {
+                    auto name = std::string(len, 'a');
+                    name[pos] = bad;
+                    INFO("len: " << len << ", pos: " << pos << ", char: " << int(bad));
+                    REQUIRE_FALSE(ion::HeaderValidator::is_valid_name(name));
+                }
+                REQUIRE(ion::HeaderValidator::is_valid_name(std::string(len, 'a')));
+            }
+        }
+    }
+}
+
+TEST_CASE("header validator: values") {
+    SECTION ("accepts visible characters, inner whitespace and obs-text") {
+        REQUIRE(ion::HeaderValidator::is_valid_value(""));
+        REQUIRE(ion::HeaderValidator::is_valid_value("text/html; charset=utf-8"));
+        REQUIRE(ion::HeaderValidator::is_valid_value("a\tb \x80\xff"));
+    }
+
+    SECTION ("rejects leading or trailing whitespace") {
+        REQUIRE_FALSE(ion::HeaderValidator::is_valid_value(" a"));
+        REQUIRE_FALSE(ion::HeaderValidator::is_valid_value("a\t"));
+    }
+
+    SECTION ("rejects NUL, CR and LF at any position") {
+        for (const char bad : {'\0', '\r', '\n'}) {
+            for (const int len : LENGTHS) {
+                for (int pos = 0; pos < len; pos++) {
+                    auto value = std::string(len, 'v');
+                    value[pos] = bad;
+                    INFO("len: " << len << ", pos: " << pos << ", char: " << int(bad));
+                    REQUIRE_FALSE(ion::HeaderValidator::is_valid_value(value));
+                }
+            }
+        }
+    }
+}
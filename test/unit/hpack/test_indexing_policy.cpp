@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "hpack/indexing_policy.h"
+
+TEST_CASE("indexing policy: chooses literal representation") {
+    auto config = ion::IndexingPolicyConfig{};
+    auto policy = ion::IndexingPolicy{config};
+
+    SECTION ("indexes ordinary headers") {
+        REQUIRE(policy.literal_type({"content-type", "text/html"}) ==
+                ion::HeaderFieldType::LiteralIncremental);
+    }
+
+    SECTION ("never indexes sensitive headers") {
+        REQUIRE(policy.literal_type({"set-cookie", "id=1"}) ==
+                ion::HeaderFieldType::LiteralNeverIndex);
+    }
+
+    SECTION ("does not index volatile headers") {
+        REQUIRE(policy.literal_type({"content-length", "123"}) ==
+                ion::HeaderFieldType::LiteralNoIndex);
+        REQUIRE(policy.literal_type({"etag", "\"abc\""}) == ion::HeaderFieldType::LiteralNoIndex);
+    }
+
+    SECTION ("does not index large entries") {
+        config.max_indexed_entry_size = 64;
+        policy = ion::IndexingPolicy{config};
+
+        REQUIRE(policy.literal_type({"x-foo", std::string(32, 'a')}) ==
+                ion::HeaderFieldType::LiteralNoIndex);
+        REQUIRE(policy.literal_type({"x-foo", std::string(16, 'a')}) ==
+                ion::HeaderFieldType::LiteralIncremental);
+    }
+}
+
+TEST_CASE("indexing policy: learns from hit counts") {
+    auto config = ion::IndexingPolicyConfig{.min_samples = 4, .min_hit_ratio = 0.5};
+    auto policy = ion::IndexingPolicy{config};
+    const auto hdr = ion::HttpHeader{"x-request-id", "1"};
+
+    SECTION ("stops indexing names that never hit") {
+        for (int i = 0; i < 3; i++) {
+            policy.record_miss(hdr.name);
+        }
+        REQUIRE(policy.literal_type(hdr) == ion::HeaderFieldType::LiteralIncremental);
+
+        policy.record_miss(hdr.name);
+        REQUIRE(policy.literal_type(hdr) == ion::HeaderFieldType::LiteralNoIndex);
+    }
+
+    SECTION ("keeps indexing names that hit") {
+        policy.record_miss(hdr.name);
+        for (int i = 0; i < 3; i++) {
+            policy.record_hit(hdr.name);
+        }
+        REQUIRE(policy.literal_type(hdr) == ion::HeaderFieldType::LiteralIncremental);
+    }
+}
+
+TEST_CASE("indexing policy: gives volatile names another chance") {
+    const auto config =
+        ion::IndexingPolicyConfig{.min_samples = 4, .min_hit_ratio = 0.5, .sample_window = 8};
+    auto policy = ion::IndexingPolicy{config};
+    const auto hdr = ion::HttpHeader{"x-build", "1"};
+
+    for (int i = 0; i < 8; i++) {
+        policy.record_miss(hdr.name);
+    }
+    REQUIRE(policy.literal_type(hdr) == ion::HeaderFieldType::LiteralNoIndex);
+
+    policy.record_miss(hdr.name);
+    REQUIRE(policy.literal_type(hdr) == ion::HeaderFieldType::LiteralIncremental);
+
+    for (int i = 0; i < 3; i++) {
+        policy.record_hit(hdr.name);
+    }
+    REQUIRE(policy.literal_type(hdr) == ion::HeaderFieldType::LiteralIncremental);
+}
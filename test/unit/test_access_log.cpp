@@ -0,0 +1,94 @@
+#include <unistd.h>
+
+#include <catch2/catch_all.hpp>
+#include <filesystem>
+#include <format>
+#include <fstream>
+
+#include "access_log.h"
+#include "spsc_ring.h"
+
+using ion::AccessLog;
+using ion::SpscRing;
+
+namespace fs = std::filesystem;
+
+TEST_CASE("spsc ring: wraps around and reports full") {
+    SpscRing<int, 4> ring;
+    CHECK(ring.front() == nullptr);
+
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 4; i++) {
+            auto* slot = ring.try_claim();
+            REQUIRE(slot != nullptr);
+            *slot = round * 10 + i;
+            ring.commit();
+        }
+        CHECK(ring.try_claim() == nullptr);
+
+        for (int i = 0; i < 4; i++) {
+            const auto* slot = ring.front();
+            REQUIRE(slot != nullptr);
+            CHECK(*slot == round * 10 + i);
+            ring.pop();
+        }
+        CHECK(ring.front() == nullptr);
+    }
+}
+
+TEST_CASE("access log: marks truncated record fields") {
+    ion::InlineString<8> field{};
+
+    field.assign("/short");
+    CHECK(field.view() == "/short");
+    CHECK_FALSE(field.truncated);
+
+    field.assign("/12345678");
+    CHECK(field.view() == "/1234...");
+    CHECK(field.truncated);
+
+    field.assign("/1234567");
+    CHECK(field.view() == "/1234567");
+    CHECK_FALSE(field.truncated);
+
+    field.assign("/1234567");
+    field.clear();
+    CHECK(field.view().empty());
+    CHECK_FALSE(field.truncated);
+}
+
+TEST_CASE("access log: writes combined log format lines") {
+    const auto path =
+        fs::temp_directory_path() / ("ion_access_log_" + std::to_string(::getpid()) + ".log");
+    fs::remove(path);
+
+    ion::HttpRequest req{.method = ion::HttpMethod::Get, .path = "/index.html"};
+    req.headers.push_back({"user-agent", "curl/8.0"});
+
+    AccessLog::open(path.string());
+    REQUIRE(AccessLog::is_open());
+    AccessLog::log_request(req, 200, 42, "127.0.0.1");
+    req.headers.clear();
+    req.path = std::string(300, 'a');
+    AccessLog::log_request(req, 404, 0, "");
+    AccessLog::close();
+    CHECK_FALSE(AccessLog::is_open());
+
+    // nothing is captured once closed
+    AccessLog::log_request(req, 200, 0, "127.0.0.1");
+
+    std::ifstream file(path);
+    std::string line;
+    REQUIRE(std::getline(file, line));
+    CHECK(line.starts_with("127.0.0.1 - - ["));
+    CHECK(line.ends_with(R"("GET /index.html HTTP/2" 200 42 "-" "curl/8.0")"));
+    REQUIRE(std::getline(file, line));
+    CHECK(line.starts_with("- - - ["));
+    // the path was cut short, which the line shows
+    CHECK(line.ends_with(
+        std::format(R"("GET {}... HTTP/2" 404 0 "-" "-")", std::string(253, 'a'))));
+    CHECK_FALSE(std::getline(file, line));
+    CHECK(AccessLog::dropped() == 0);
+
+    fs::remove(path);
+}
@@ -0,0 +1,262 @@
+#include <unistd.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include "access_log_binary.h"
+
+using ion::AccessLogRecord;
+using ion::BinaryAccessLogDecoder;
+using ion::BinaryAccessLogEncoder;
+using namespace std::chrono_literals;
+
+namespace fs = std::filesystem;
+
+static AccessLogRecord make_record(std::chrono::system_clock::time_point time,
+                                   std::string_view path) {
+    AccessLogRecord record{.time = time, .content_length = 1234, .status_code = 200};
+    record.method.assign("GET");
+    record.client_ip.assign("192.168.1.20");
+    record.path.assign(path);
+    record.referrer.assign("");
+    record.user_agent.assign("Mozilla/5.0 (X11; Linux x86_64; rv:131.0) Gecko/20100101");
+    return record;
+}
+
+static std::span<const uint8_t> as_bytes(const std::string& data) {
+    return {reinterpret_cast<const uint8_t*>(data.data()), data.size()};
+}
+
+static std::vector<std::string> decode_clf(BinaryAccessLogDecoder& decoder,
+                                           std::span<const uint8_t> data, size_t& consumed) {
+    std::vector<std::string> lines{};
+    const auto result = decoder.decode(data, [&](const AccessLogRecord& record) {
+        std::string line{};
+        ion::AccessLog::format_clf(record, line);
+        lines.push_back(line);
+    });
+    REQUIRE(result);
+    consumed = *result;
+    return lines;
+}
+
+TEST_CASE("binary access log: round trips records") {
+    const auto start = std::chrono::system_clock::from_time_t(1'700'000'000);
+    std::vector<AccessLogRecord> records{};
+    for (int i = 0; i < 100; i++) {
+        // timestamps from several rings aren't strictly ordered
+        const auto path = i % 3 == 0 ? "/index.html" : "/api/items/" + std::to_string(i);
+        records.push_back(make_record(start + (i % 2 == 0 ? 1s : -1s) * i, path));
+    }
+
+    BinaryAccessLogEncoder encoder{};
+    std::string data{};
+    std::string text{};
+    encoder.begin_segment(data);
+    for (const auto& record : records) {
+        encoder.append(record, data);
+        ion::AccessLog::format_clf(record, text);
+        if (encoder.pending_bytes() > 512) {
+            encoder.finish_chunk(data);
+        }
+    }
+    encoder.finish_chunk(data);
+
+    // repeated strings are interned, so the log is far smaller than the text
+    CHECK(data.size() * 4 < text.size());
+
+    BinaryAccessLogDecoder decoder{};
+    size_t consumed = 0;
+    const auto lines = decode_clf(decoder, as_bytes(data), consumed);
+    CHECK(consumed == data.size());
+
+    std::string decoded_text{};
+    for (const auto& line : lines) {
+        decoded_text += line;
+    }
+    CHECK(lines.size() == records.size());
+    CHECK(decoded_text == text);
+
+    SECTION ("a partial chunk is left for the next call") {
+        BinaryAccessLogDecoder partial_decoder{};
+        const auto bytes = as_bytes(data);
+        size_t first = 0;
+        const auto head = decode_clf(partial_decoder, bytes.first(bytes.size() - 1), first);
+        CHECK(first < bytes.size() - 1);
+        CHECK(head.size() < records.size());
+
+        size_t second = 0;
+        const auto tail = decode_clf(partial_decoder, bytes.subspan(first), second);
+        CHECK(first + second == bytes.size());
+        CHECK(head.size() + tail.size() == records.size());
+    }
+
+    SECTION ("a new segment restarts the string table") {
+        std::string appended = data;
+        encoder.begin_segment(appended);
+        encoder.append(records.back(), appended);
+        encoder.finish_chunk(appended);
+
+        BinaryAccessLogDecoder appended_decoder{};
+        const auto all = decode_clf(appended_decoder, as_bytes(appended), consumed);
+        REQUIRE(all.size() == records.size() + 1);
+        CHECK(all.back() == lines.back());
+    }
+}
+
+TEST_CASE("binary access log: starts a new segment once the string table is full") {
+    const auto now = std::chrono::system_clock::now();
+    BinaryAccessLogEncoder encoder{};
+    std::string data{};
+    encoder.begin_segment(data);
+    const size_t count = BinaryAccessLogEncoder::MAX_INTERNED_STRINGS + 10;
+    for (size_t i = 0; i < count; i++) {
+        encoder.append(make_record(now, "/unique/" + std::to_string(i)), data);
+    }
+    encoder.append(make_record(now, "/unique/0"), data);
+    encoder.finish_chunk(data);
+
+    const std::string segment_marker{"\x01\x07ionlog"};
+    size_t segments = 0;
+    for (auto pos = data.find(segment_marker); pos != std::string::npos;
+         pos = data.find(segment_marker, pos + 1)) {
+        segments++;
+    }
+    CHECK(segments == 2);
+
+    BinaryAccessLogDecoder decoder{};
+    std::vector<std::string> paths{};
+    const auto consumed =
+        decoder.decode(as_bytes(data), [&](const AccessLogRecord& record) {
+            paths.emplace_back(record.path.view());
+        });
+    REQUIRE(consumed == data.size());
+    REQUIRE(paths.size() == count + 1);
+    CHECK(paths[count - 1] == "/unique/" + std::to_string(count - 1));
+    CHECK(paths.back() == "/unique/0");
+    CHECK(decoder.skipped_bytes() == 0);
+}
+
+TEST_CASE("binary access log: rejects invalid input") {
+    BinaryAccessLogDecoder decoder{};
+    const auto ignore = [](const AccessLogRecord&) {};
+
+    const std::string records_first{"\x02\x01\x00", 3};
+    CHECK(decoder.decode(as_bytes(records_first), ignore).error() ==
+          ion::BinaryAccessLogError::MissingSegment);
+
+    const std::string bad_version{"\x01\x07ionlog\x09", 9};
+    CHECK(decoder.decode(as_bytes(bad_version), ignore).error() ==
+          ion::BinaryAccessLogError::UnsupportedVersion);
+
+    const std::string text{"127.0.0.1 - - [10/Oct/2000:13:55:36 -0700] ..."};
+    CHECK(decoder.decode(as_bytes(text), ignore).error() ==
+          ion::BinaryAccessLogError::UnknownChunk);
+}
+
+TEST_CASE("binary access log: resyncs on the next segment after a torn chunk") {
+    const auto now = std::chrono::system_clock::now();
+    BinaryAccessLogEncoder encoder{};
+    std::string data{};
+    encoder.begin_segment(data);
+    encoder.append(make_record(now, "/before"), data);
+    encoder.finish_chunk(data);
+
+    // a write that failed part way through, after which the writer starts a new segment
+    const size_t torn_records = GENERATE(1, 200);
+    std::string torn{};
+    for (size_t i = 0; i < torn_records; i++) {
+        encoder.append(make_record(now, "/torn/" + std::to_string(i)), torn);
+    }
+    encoder.finish_chunk(torn);
+    data.append(torn, 0, torn.size() / 2);
+    encoder.begin_segment(data);
+    for (size_t i = 0; i < 20; i++) {
+        encoder.append(make_record(now, "/after"), data);
+    }
+    encoder.finish_chunk(data);
+
+    BinaryAccessLogDecoder decoder{};
+    std::vector<std::string> paths{};
+    const auto consumed = decoder.decode(
+        as_bytes(data), [&](const AccessLogRecord& record) { paths.emplace_back(record.path.view()); },
+        true);
+    REQUIRE(consumed == data.size());
+    REQUIRE(paths.size() == 21);
+    CHECK(paths.front() == "/before");
+    CHECK(paths.back() == "/after");
+    CHECK(decoder.skipped_bytes() == torn.size() / 2);
+
+    SECTION ("but treats a truncated last chunk as truncation") {
+        std::string truncated{};
+        encoder.begin_segment(truncated);
+        encoder.append(make_record(now, "/last"), truncated);
+        encoder.finish_chunk(truncated);
+        truncated.pop_back();
+
+        BinaryAccessLogDecoder truncated_decoder{};
+        const auto ignore = [](const AccessLogRecord&) {};
+        REQUIRE(truncated_decoder.decode(as_bytes(truncated), ignore, true) == 9);
+        CHECK(truncated_decoder.skipped_bytes() == 0);
+    }
+}
+
+TEST_CASE("binary access log: resyncs after a time delta out of range") {
+    const auto now = std::chrono::system_clock::now();
+    BinaryAccessLogEncoder encoder{};
+    std::string data{};
+    encoder.begin_segment(data);
+
+    // one record whose time delta (zigzag encoded INT64_MAX) would overflow the timestamp
+    const std::string bad_payload{
+        "\xfe\xff\xff\xff\xff\xff\xff\xff\xff\x01"  // time delta
+        "\xc8\x01\x00"                                // status code 200, content length 0
+        "\x01\x00\x01\x00\x01\x00\x01\x00\x01\x00",  // five empty literal strings
+        23};
+    const std::string bad_chunk = std::string{"\x02"} + static_cast<char>(bad_payload.size()) +
+                                  bad_payload;
+    data.append(bad_chunk);
+
+    encoder.begin_segment(data);
+    encoder.append(make_record(now, "/after"), data);
+    encoder.finish_chunk(data);
+
+    BinaryAccessLogDecoder decoder{};
+    std::vector<std::string> paths{};
+    const auto consumed = decoder.decode(
+        as_bytes(data), [&](const AccessLogRecord& record) { paths.emplace_back(record.path.view()); },
+        true);
+    REQUIRE(consumed == data.size());
+    REQUIRE(paths.size() == 1);
+    CHECK(paths.front() == "/after");
+    CHECK(decoder.skipped_bytes() == bad_chunk.size());
+}
+
+TEST_CASE("access log: writes binary records") {
+    const auto path =
+        fs::temp_directory_path() / ("ion_access_log_" + std::to_string(::getpid()) + ".bin");
+    fs::remove(path);
+
+    ion::HttpRequest req{.method = ion::HttpMethod::Post, .path = "/upload"};
+    ion::AccessLog::open(path.string(), ion::AccessLogFormat::Binary);
+    ion::AccessLog::log_request(req, 201, 7, "10.0.0.1");
+    ion::AccessLog::log_request(req, 201, 8, "10.0.0.1");
+    ion::AccessLog::close();
+
+    std::ifstream file(path, std::ios::binary);
+    const std::string data{std::istreambuf_iterator<char>(file), {}};
+
+    BinaryAccessLogDecoder decoder{};
+    size_t consumed = 0;
+    const auto lines = decode_clf(decoder, as_bytes(data), consumed);
+    CHECK(consumed == data.size());
+    REQUIRE(lines.size() == 2);
+    CHECK(lines[0].starts_with("10.0.0.1 - - ["));
+    CHECK(lines[0].ends_with(R"("POST /upload HTTP/2" 201 7 "-" "-")"
+                             "\n"));
+
+    fs::remove(path);
+}
@@ -0,0 +1,36 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "buffer_pool.h"
+
+TEST_CASE("buffer pool: reuses released buffers") {
+    ion::BufferPool pool{1024, 1};
+
+    auto first = pool.acquire();
+    REQUIRE(first.capacity() >= 1024);
+    first.assign(100, 0xAB);
+    const auto* storage = first.data();
+
+    pool.release(first);
+    REQUIRE(first.capacity() == 0);
+    REQUIRE(pool.pooled() == 1);
+
+    auto second = pool.acquire();
+    REQUIRE(second.empty());
+    REQUIRE(second.data() == storage);
+    REQUIRE(pool.pooled() == 0);
+
+    SECTION ("frees buffers beyond the pool limit") {
+        auto third = pool.acquire();
+        pool.release(second);
+        pool.release(third);
+        REQUIRE(pool.pooled() == 1);
+        REQUIRE(third.capacity() == 0);
+    }
+
+    SECTION ("frees buffers that grew too large") {
+        second.resize(pool.max_buffer_capacity() + 1);
+        pool.release(second);
+        REQUIRE(pool.pooled() == 0);
+        REQUIRE(second.capacity() == 0);
+    }
+}
@@ -0,0 +1,92 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "compiled_route_table.h"
+#include "router.h"
+
+struct OkHandler {
+    ion::HttpResponse operator()(const ion::HttpRequest&) const {
+        return ion::HttpResponse{.status_code = 200};
+    }
+};
+
+struct CreatedHandler {
+    ion::HttpResponse operator()(const ion::HttpRequest&) const {
+        return ion::HttpResponse{.status_code = 201};
+    }
+};
+
+struct CountingHandler {
+    int* calls;
+
+    ion::HttpResponse operator()(const ion::HttpRequest&) const {
+        (*calls)++;
+        return ion::HttpResponse{.status_code = 202};
+    }
+};
+
+using Routes = ion::CompiledRouteTable<ion::CompiledRoute<"GET", "/", OkHandler>,
+                                       ion::CompiledRoute<"POST", "/items", CreatedHandler>,
+                                       ion::CompiledRoute<"GET", "/items", OkHandler>,
+                                       ion::CompiledRoute<"GET", "/health", OkHandler>>;
+
+// a table with these would fail its static_assert rather than search for a hash forever
+static_assert(!ion::detail::routes_are_unique<ion::CompiledRoute<"GET", "/a", OkHandler>,
+                                              ion::CompiledRoute<"POST", "/a", OkHandler>,
+                                              ion::CompiledRoute<"GET", "/a", CreatedHandler>>());
+static_assert(ion::detail::routes_are_unique<ion::CompiledRoute<"GET", "/a", OkHandler>,
+                                             ion::CompiledRoute<"POST", "/a", OkHandler>>());
+
+static ion::HttpResponse dispatch(const ion::RequestDispatcher& dispatcher,
+                                  const std::string& method, const std::string& path) {
+    auto req = ion::HttpRequest{.method = ion::HttpMethodHelper::from_string(method),
+                                .path = path,
+                                .method_name = method};
+    return dispatcher.dispatch(req);
+}
+
+TEST_CASE("compiled route table: dispatches fixed routes") {
+    const auto routes = Routes{};
+
+    SECTION ("matches method and path") {
+        REQUIRE(dispatch(routes, "GET", "/").status_code == 200);
+        REQUIRE(dispatch(routes, "POST", "/items").status_code == 201);
+        REQUIRE(dispatch(routes, "GET", "/items").status_code == 200);
+    }
+
+    SECTION ("ignores the query string") {
+        REQUIRE(dispatch(routes, "POST", "/items?page=2").status_code == 201);
+    }
+
+    SECTION ("sets the matching route on the request") {
+        auto req = ion::HttpRequest{.method = ion::HttpMethod::Get, .path = "/items?page=2"};
+        REQUIRE(routes.dispatch(req).status_code == 200);
+        REQUIRE(req.route == "/items");
+    }
+
+    SECTION ("returns 404 for unknown routes") {
+        REQUIRE(dispatch(routes, "DELETE", "/items").status_code == 404);
+        REQUIRE(dispatch(routes, "GET", "/missing").status_code == 404);
+        REQUIRE(dispatch(routes, "GET", "").status_code == 404);
+    }
+
+    SECTION ("falls back to another dispatcher") {
+        auto fallback = ion::Router{};
+        fallback.add_route("/other", "GET",
+                           [](auto&) { return ion::HttpResponse{.status_code = 203}; });
+        auto with_fallback = Routes{};
+        with_fallback.set_fallback(fallback);
+
+        REQUIRE(dispatch(with_fallback, "GET", "/other").status_code == 203);
+        REQUIRE(dispatch(with_fallback, "GET", "/health").status_code == 200);
+    }
+}
+
+TEST_CASE("compiled route table: uses handler instances") {
+    int calls = 0;
+    const auto routes = ion::CompiledRouteTable<ion::CompiledRoute<"GET", "/count", CountingHandler>>{
+        CountingHandler{&calls}};
+
+    REQUIRE(dispatch(routes, "GET", "/count").status_code == 202);
+    REQUIRE(dispatch(routes, "GET", "/count").status_code == 202);
+    REQUIRE(calls == 2);
+}
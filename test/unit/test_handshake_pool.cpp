@@ -0,0 +1,31 @@
+#include <poll.h>
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+
+#include "handshake_pool.h"
+#include "transports/memory_transport.h"
+
+TEST_CASE("handshake pool: runs handshakes on workers and reports results") {
+    ion::HandshakePool pool{2};
+    std::vector<ion::MemoryTransport> transports(8);
+    for (size_t i = 0; i < transports.size(); i++) {
+        pool.submit(static_cast<int>(i), transports[i]);
+    }
+
+    std::vector<ion::HandshakeResult> results{};
+    while (results.size() < transports.size()) {
+        pollfd wake{.fd = pool.wake_fd(), .events = POLLIN, .revents = 0};
+        REQUIRE(poll(&wake, 1, 5000) == 1);
+        for (auto& result : pool.drain()) {
+            results.push_back(result);
+        }
+    }
+
+    std::vector<bool> seen(transports.size());
+    for (const auto& [fd, result] : results) {
+        REQUIRE(result.has_value());
+        seen[static_cast<size_t>(fd)] = true;
+    }
+    REQUIRE(std::ranges::all_of(seen, [](bool s) { return s; }));
+}
@@ -0,0 +1,437 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+#include "hpack/header_block_decoder.h"
+#include "hpack/header_block_encoder.h"
+#include "http2_conn.h"
+#include "router.h"
+#include "server_metrics.h"
+#include "transports/memory_transport.h"
+
+static constexpr std::string_view CLIENT_PREFACE{"PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"};
+
+static void append_frame(std::vector<uint8_t>& out, uint8_t type, uint8_t flags,
+                         uint32_t stream_id, std::span<const uint8_t> payload) {
+    const ion::Http2FrameHeader header{.length = static_cast<uint32_t>(payload.size()),
+                                       .type = type,
+                                       .flags = flags,
+                                       .stream_id = stream_id};
+    std::array<uint8_t, ion::Http2FrameHeader::wire_size> header_bytes{};
+    header.serialize(header_bytes);
+    out.insert(out.end(), header_bytes.begin(), header_bytes.end());
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+struct ReceivedFrame {
+    ion::Http2FrameHeader header;
+    std::vector<uint8_t> payload;
+};
+
+static std::vector<ReceivedFrame> split_frames(std::span<const uint8_t> data) {
+    std::vector<ReceivedFrame> frames{};
+    while (data.size() >= ion::Http2FrameHeader::wire_size) {
+        const auto header =
+            ion::Http2FrameHeader::parse(data.subspan<0, ion::Http2FrameHeader::wire_size>());
+        const auto payload = data.subspan(ion::Http2FrameHeader::wire_size, header.length);
+        frames.push_back({header, {payload.begin(), payload.end()}});
+        data = data.subspan(ion::Http2FrameHeader::wire_size + header.length);
+    }
+    return frames;
+}
+
+static std::vector<uint8_t> window_update(uint32_t stream_id, uint32_t increment) {
+    std::vector<uint8_t> frame{};
+    std::array<uint8_t, ion::Http2WindowUpdate::wire_size> payload{};
+    ion::Http2WindowUpdate{.window_size_increment = increment}.serialize(payload);
+    append_frame(frame, 0x08, 0x00, stream_id, payload);
+    return frame;
+}
+
+TEST_CASE("connection: serves requests over an in-memory transport") {
+    // tracing is skipped for unsampled requests, which must be served the same way
+    const auto sampler = ion::RequestSampler{GENERATE(1.0, 0.0)};
+    auto router = ion::Router{};
+    router.add_route("/hello", "GET", [](const ion::HttpRequest&) {
+        return ion::HttpResponse{.status_code = 200, .body = {'h', 'i'}};
+    });
+
+    const auto metrics_before = ion::ServerMetrics::snapshot();
+    auto transport = std::make_unique<ion::MemoryTransport>();
+    auto* memory_transport = transport.get();
+    ion::Http2Connection conn{std::move(transport), "127.0.0.1", router,
+                              ion::DEFAULT_INDEXING_POLICY_CONFIG, sampler};
+
+    auto client_table = ion::DynamicTable{4096};
+    auto client_encoder = ion::HeaderBlockEncoder{client_table};
+    std::vector<uint8_t> input{CLIENT_PREFACE.begin(), CLIENT_PREFACE.end()};
+    append_frame(input, 0x04, 0x00, 0, {});
+    append_frame(input, 0x01, 0x05, 1,
+                 client_encoder.encode(
+                     {{":method", "GET"}, {":scheme", "https"}, {":path", "/hello"}}));
+    memory_transport->feed(input);
+
+    REQUIRE(conn.process() == ion::Http2ProcessResult::WantRead);
+
+    const auto frames = split_frames(memory_transport->output());
+    REQUIRE(frames.size() == 4);
+    REQUIRE(frames[0].header.type == 0x04);  // server SETTINGS
+    REQUIRE(frames[1].header.type == 0x04);  // SETTINGS ACK
+    REQUIRE(frames[1].header.flags == 0x01);
+    REQUIRE(frames[2].header.type == 0x01);
+    REQUIRE(frames[2].header.stream_id == 1);
+    REQUIRE(frames[3].header.type == 0x00);
+    REQUIRE(frames[3].payload == std::vector<uint8_t>{'h', 'i'});
+
+    auto server_table = ion::DynamicTable{};
+    auto decoder = ion::HeaderBlockDecoder{server_table};
+    const auto resp_hdrs = decoder.decode(frames[2].payload);
+    REQUIRE(resp_hdrs);
+    REQUIRE((*resp_hdrs)[0].name == ":status");
+    REQUIRE((*resp_hdrs)[0].value == "200");
+    const auto date = std::ranges::find(*resp_hdrs, "date", &ion::HttpHeader::name);
+    REQUIRE(date != resp_hdrs->end());
+    REQUIRE(date->value.ends_with(" GMT"));
+
+    SECTION ("counts its traffic in the server metrics") {
+        const auto metrics = ion::ServerMetrics::snapshot();
+        REQUIRE(metrics.active_connections == metrics_before.active_connections + 1);
+        REQUIRE(metrics.active_streams == metrics_before.active_streams);
+        REQUIRE(metrics.bytes_received - metrics_before.bytes_received == input.size());
+        REQUIRE(metrics.bytes_sent - metrics_before.bytes_sent ==
+                memory_transport->output().size());
+    }
+
+    SECTION ("releases its buffers once idle") {
+        REQUIRE(conn.memory_usage() < 4 * 1024);
+    }
+
+    SECTION ("discards the connection once the client closes") {
+        memory_transport->close_input();
+
+        REQUIRE(conn.process() == ion::Http2ProcessResult::DiscardConnection);
+    }
+}
+
+TEST_CASE("connection: streams file bodies as DATA frames") {
+    const auto path = std::filesystem::temp_directory_path() /
+                      ("ion_file_body_" + std::to_string(::getpid()) + ".bin");
+    std::vector<uint8_t> content(40000);
+    for (size_t i = 0; i < content.size(); i++) {
+        content[i] = static_cast<uint8_t>(i * 7);
+    }
+    std::ofstream(path, std::ios::binary)
+        .write(reinterpret_cast<const char*>(content.data()),
+               static_cast<std::streamsize>(content.size()));
+
+    auto router = ion::Router{};
+    router.add_route("/file", "GET", [&](const ion::HttpRequest&) {
+        return ion::HttpResponse{.status_code = 200, .file_body = ion::FileBody::open(path)};
+    });
+
+    auto transport = std::make_unique<ion::MemoryTransport>();
+    auto* memory_transport = transport.get();
+    SECTION ("with sendfile") {}
+    SECTION ("with buffered fallback") {
+        memory_transport->disable_send_file();
+    }
+    ion::Http2Connection conn{std::move(transport), "127.0.0.1", router};
+
+    auto client_table = ion::DynamicTable{4096};
+    auto client_encoder = ion::HeaderBlockEncoder{client_table};
+    std::vector<uint8_t> input{CLIENT_PREFACE.begin(), CLIENT_PREFACE.end()};
+    append_frame(input, 0x01, 0x05, 1,
+                 client_encoder.encode(
+                     {{":method", "GET"}, {":scheme", "https"}, {":path", "/file"}}));
+    memory_transport->feed(input);
+
+    REQUIRE(conn.process() == ion::Http2ProcessResult::WantRead);
+
+    const auto frames = split_frames(memory_transport->output());
+    REQUIRE(frames.size() == 5);
+    REQUIRE(frames[1].header.type == 0x01);
+    REQUIRE(frames[1].header.flags == 0x04);
+
+    std::vector<uint8_t> received{};
+    for (size_t i = 2; i < frames.size(); i++) {
+        REQUIRE(frames[i].header.type == 0x00);
+        REQUIRE(frames[i].header.stream_id == 1);
+        REQUIRE(frames[i].header.flags == (i + 1 == frames.size() ? 0x01 : 0x00));
+        received.insert(received.end(), frames[i].payload.begin(), frames[i].payload.end());
+    }
+    REQUIRE(received == content);
+
+    auto server_table = ion::DynamicTable{};
+    auto decoder = ion::HeaderBlockDecoder{server_table};
+    const auto resp_hdrs = decoder.decode(frames[1].payload);
+    REQUIRE(resp_hdrs);
+    const auto content_length =
+        std::ranges::find(*resp_hdrs, "content-length", &ion::HttpHeader::name);
+    REQUIRE(content_length != resp_hdrs->end());
+    REQUIRE(content_length->value == "40000");
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("connection: keeps a date header set by the handler") {
+    const auto pre_encoded = std::make_shared<const ion::PreEncodedHeaders>(
+        ion::HeaderBlockEncoder::pre_encode({{"date", "Sun, 06 Nov 1994 08:49:37 GMT"}}));
+    auto router = ion::Router{};
+    router.add_route("/dated", "GET", [&](const ion::HttpRequest&) {
+        return ion::HttpResponse{.status_code = 200, .pre_encoded_headers = pre_encoded};
+    });
+
+    auto transport = std::make_unique<ion::MemoryTransport>();
+    auto* memory_transport = transport.get();
+    ion::Http2Connection conn{std::move(transport), "127.0.0.1", router};
+
+    auto client_table = ion::DynamicTable{4096};
+    auto client_encoder = ion::HeaderBlockEncoder{client_table};
+    std::vector<uint8_t> input{CLIENT_PREFACE.begin(), CLIENT_PREFACE.end()};
+    append_frame(input, 0x01, 0x05, 1,
+                 client_encoder.encode(
+                     {{":method", "GET"}, {":scheme", "https"}, {":path", "/dated"}}));
+    memory_transport->feed(input);
+
+    REQUIRE(conn.process() == ion::Http2ProcessResult::WantRead);
+
+    const auto frames = split_frames(memory_transport->output());
+    REQUIRE(frames.size() == 2);
+    REQUIRE(frames[1].header.type == 0x01);
+
+    auto server_table = ion::DynamicTable{};
+    auto decoder = ion::HeaderBlockDecoder{server_table};
+    const auto resp_hdrs = decoder.decode(frames[1].payload);
+    REQUIRE(resp_hdrs);
+    REQUIRE(std::ranges::count(*resp_hdrs, "date", &ion::HttpHeader::name) == 1);
+    const auto date = std::ranges::find(*resp_hdrs, "date", &ion::HttpHeader::name);
+    REQUIRE(date->value == "Sun, 06 Nov 1994 08:49:37 GMT");
+}
+
+TEST_CASE("connection: sends file bodies within the peer's flow-control windows") {
+    const auto path = std::filesystem::temp_directory_path() /
+                      ("ion_file_window_" + std::to_string(::getpid()) + ".bin");
+    const std::vector<uint8_t> content(40000, 'x');
+    std::ofstream(path, std::ios::binary)
+        .write(reinterpret_cast<const char*>(content.data()),
+               static_cast<std::streamsize>(content.size()));
+
+    auto router = ion::Router{};
+    router.add_route("/file", "GET", [&](const ion::HttpRequest&) {
+        return ion::HttpResponse{.status_code = 200, .file_body = ion::FileBody::open(path)};
+    });
+    router.add_route("/hello", "GET", [](const ion::HttpRequest&) {
+        return ion::HttpResponse{.status_code = 200, .body = {'h', 'i'}};
+    });
+
+    auto transport = std::make_unique<ion::MemoryTransport>();
+    auto* memory_transport = transport.get();
+    SECTION ("with sendfile") {}
+    SECTION ("with buffered fallback") {
+        memory_transport->disable_send_file();
+    }
+    ion::Http2Connection conn{std::move(transport), "127.0.0.1", router};
+
+    auto client_table = ion::DynamicTable{4096};
+    auto client_encoder = ion::HeaderBlockEncoder{client_table};
+    std::vector<uint8_t> input{CLIENT_PREFACE.begin(), CLIENT_PREFACE.end()};
+    std::array<uint8_t, ion::Http2Setting::wire_size> initial_window{};
+    ion::Http2Setting{.identifier = 0x0004, .value = 20000}.serialize(initial_window);
+    append_frame(input, 0x04, 0x00, 0, initial_window);
+    append_frame(input, 0x01, 0x05, 1,
+                 client_encoder.encode(
+                     {{":method", "GET"}, {":scheme", "https"}, {":path", "/file"}}));
+    memory_transport->feed(input);
+
+    REQUIRE(conn.process() == ion::Http2ProcessResult::WantRead);
+
+    const auto data_sent = [&] {
+        size_t sent = 0;
+        for (const auto& frame : split_frames(memory_transport->output())) {
+            if (frame.header.type == 0x00 && frame.header.stream_id == 1) {
+                sent += frame.payload.size();
+            }
+        }
+        return sent;
+    };
+    REQUIRE(data_sent() == 20000);
+
+    // other streams are still served while the file waits for its window
+    memory_transport->clear_output();
+    input.clear();
+    append_frame(input, 0x01, 0x05, 3,
+                 client_encoder.encode(
+                     {{":method", "GET"}, {":scheme", "https"}, {":path", "/hello"}}));
+    memory_transport->feed(input);
+
+    REQUIRE(conn.process() == ion::Http2ProcessResult::WantRead);
+    auto frames = split_frames(memory_transport->output());
+    REQUIRE(frames.size() == 2);
+    REQUIRE(frames[0].header.stream_id == 3);
+    REQUIRE(frames[1].payload == std::vector<uint8_t>{'h', 'i'});
+
+    memory_transport->clear_output();
+    input.clear();
+    std::array<uint8_t, ion::Http2WindowUpdate::wire_size> increment{};
+    ion::Http2WindowUpdate{.window_size_increment = 20000}.serialize(increment);
+    append_frame(input, 0x08, 0x00, 1, increment);
+    memory_transport->feed(input);
+
+    REQUIRE(conn.process() == ion::Http2ProcessResult::WantRead);
+    REQUIRE(data_sent() == 20000);
+    frames = split_frames(memory_transport->output());
+    REQUIRE(frames.back().header.flags == 0x01);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("connection: sends memory bodies within the peer's flow-control windows") {
+    const std::vector<uint8_t> content(70000, 'm');
+    auto router = ion::Router{};
+    router.add_route("/big", "GET", [&](const ion::HttpRequest&) {
+        return ion::HttpResponse{.status_code = 200, .body = content};
+    });
+
+    auto transport = std::make_unique<ion::MemoryTransport>();
+    auto* memory_transport = transport.get();
+    ion::Http2Connection conn{std::move(transport), "127.0.0.1", router};
+
+    auto client_table = ion::DynamicTable{4096};
+    auto client_encoder = ion::HeaderBlockEncoder{client_table};
+    std::vector<uint8_t> input{CLIENT_PREFACE.begin(), CLIENT_PREFACE.end()};
+    append_frame(input, 0x01, 0x05, 1,
+                 client_encoder.encode(
+                     {{":method", "GET"}, {":scheme", "https"}, {":path", "/big"}}));
+    memory_transport->feed(input);
+
+    REQUIRE(conn.process() == ion::Http2ProcessResult::WantRead);
+
+    size_t sent = 0;
+    const auto data_frames = [&] {
+        auto frames = split_frames(memory_transport->output());
+        std::erase_if(frames, [](const ReceivedFrame& frame) { return frame.header.type != 0x00; });
+        for (const auto& frame : frames) {
+            REQUIRE(frame.header.length <= 16384);
+            sent += frame.payload.size();
+        }
+        memory_transport->clear_output();
+        return frames;
+    };
+    data_frames();
+    REQUIRE(sent == 65535);
+
+    // the stream's window alone isn't enough while the connection's is used up
+    memory_transport->feed(window_update(1, 10000));
+    REQUIRE(conn.process() == ion::Http2ProcessResult::WantRead);
+    REQUIRE(data_frames().empty());
+
+    memory_transport->feed(window_update(0, 10000));
+    REQUIRE(conn.process() == ion::Http2ProcessResult::WantRead);
+    const auto frames = data_frames();
+    REQUIRE(sent == content.size());
+    REQUIRE(frames.back().header.flags == 0x01);
+}
+
+TEST_CASE("connection: handles invalid WINDOW_UPDATE frames") {
+    auto router = ion::Router{};
+    auto transport = std::make_unique<ion::MemoryTransport>();
+    auto* memory_transport = transport.get();
+    ion::Http2Connection conn{std::move(transport), "127.0.0.1", router};
+
+    std::vector<uint8_t> input{CLIENT_PREFACE.begin(), CLIENT_PREFACE.end()};
+    append_frame(input, 0x04, 0x00, 0, {});
+    memory_transport->feed(input);
+    REQUIRE(conn.process() == ion::Http2ProcessResult::WantRead);
+    memory_transport->clear_output();
+
+    const auto error_code = [](const ReceivedFrame& frame) {
+        return ion::load_uint32_be(std::span(frame.payload).last<4>());
+    };
+
+    SECTION ("resets the stream for a zero increment on a stream") {
+        memory_transport->feed(window_update(1, 0));
+
+        REQUIRE(conn.process() == ion::Http2ProcessResult::WantRead);
+        const auto frames = split_frames(memory_transport->output());
+        REQUIRE(frames.size() == 1);
+        REQUIRE(frames[0].header.type == 0x03);
+        REQUIRE(frames[0].header.stream_id == 1);
+        REQUIRE(error_code(frames[0]) == 0x01);
+    }
+
+    SECTION ("resets the stream when its window overflows") {
+        // two responses share the connection's window, so neither can be sent in full
+        const std::vector<uint8_t> content(65535, 'm');
+        router.add_route("/big", "GET", [&](const ion::HttpRequest&) {
+            return ion::HttpResponse{.status_code = 200, .body = content};
+        });
+        auto client_table = ion::DynamicTable{4096};
+        auto client_encoder = ion::HeaderBlockEncoder{client_table};
+        input.clear();
+        append_frame(input, 0x01, 0x05, 1,
+                     client_encoder.encode(
+                         {{":method", "GET"}, {":scheme", "https"}, {":path", "/big"}}));
+        append_frame(input, 0x01, 0x05, 3,
+                     client_encoder.encode(
+                         {{":method", "GET"}, {":scheme", "https"}, {":path", "/big"}}));
+        memory_transport->feed(input);
+        REQUIRE(conn.process() == ion::Http2ProcessResult::WantRead);
+        memory_transport->clear_output();
+
+        memory_transport->feed(window_update(3, 0x7FFFFFFF));
+
+        REQUIRE(conn.process() == ion::Http2ProcessResult::WantRead);
+        const auto frames = split_frames(memory_transport->output());
+        REQUIRE(frames.size() == 1);
+        REQUIRE(frames[0].header.type == 0x03);
+        REQUIRE(frames[0].header.stream_id == 3);
+        REQUIRE(error_code(frames[0]) == 0x03);
+    }
+
+    SECTION ("closes the connection when SETTINGS overflows a stream's window") {
+        // the connection's window is used up, so both streams stay queued
+        const std::vector<uint8_t> content(65535, 'm');
+        router.add_route("/big", "GET", [&](const ion::HttpRequest&) {
+            return ion::HttpResponse{.status_code = 200, .body = content};
+        });
+        auto client_table = ion::DynamicTable{4096};
+        auto client_encoder = ion::HeaderBlockEncoder{client_table};
+        input.clear();
+        for (const uint32_t stream_id : {1, 3}) {
+            append_frame(input, 0x01, 0x05, stream_id,
+                         client_encoder.encode(
+                             {{":method", "GET"}, {":scheme", "https"}, {":path", "/big"}}));
+        }
+        memory_transport->feed(input);
+        REQUIRE(conn.process() == ion::Http2ProcessResult::WantRead);
+        memory_transport->clear_output();
+
+        // each step alone keeps the window within 2^31-1
+        input = window_update(3, 0x7FFFFFFF - 65535);
+        std::array<uint8_t, ion::Http2Setting::wire_size> initial_window{};
+        ion::Http2Setting{.identifier = 0x0004, .value = 0x7FFFFFFF}.serialize(initial_window);
+        append_frame(input, 0x04, 0x00, 0, initial_window);
+        memory_transport->feed(input);
+
+        REQUIRE(conn.process() == ion::Http2ProcessResult::DiscardConnection);
+        const auto frames = split_frames(memory_transport->output());
+        REQUIRE(frames.back().header.type == 0x07);
+        REQUIRE(error_code(frames.back()) == 0x03);
+    }
+
+    SECTION ("closes the connection with FRAME_SIZE_ERROR for a bad length") {
+        input.clear();
+        append_frame(input, 0x08, 0x00, 0, std::vector<uint8_t>{0, 0, 1});
+        memory_transport->feed(input);
+
+        REQUIRE(conn.process() == ion::Http2ProcessResult::DiscardConnection);
+        const auto frames = split_frames(memory_transport->output());
+        REQUIRE(frames.back().header.type == 0x07);
+        REQUIRE(error_code(frames.back()) == 0x06);
+    }
+}
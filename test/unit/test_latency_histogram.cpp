@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <thread>
+
+#include "latency_histogram.h"
+
+using ion::LatencyBuckets;
+using ion::LatencyHistogram;
+using ion::LatencyHistogramSnapshot;
+
+TEST_CASE("latency buckets: bound every value to within about 3%") {
+    for (size_t i = 0; i < LatencyBuckets::COUNT; i++) {
+        const auto lower = LatencyBuckets::lower_bound(i);
+        const auto upper = LatencyBuckets::upper_bound(i);
+        REQUIRE(lower <= upper);
+        REQUIRE(LatencyBuckets::index_of(lower) == i);
+        REQUIRE(LatencyBuckets::index_of(upper) == i);
+        REQUIRE((upper - lower) * 32 <= std::max<uint64_t>(lower, 32));
+    }
+
+    CHECK(LatencyBuckets::index_of(0) == 0);
+    CHECK(LatencyBuckets::index_of(63) == 63);
+    CHECK(LatencyBuckets::index_of(64) == 64);
+    CHECK(LatencyBuckets::index_of(65) == 64);
+    CHECK(LatencyBuckets::upper_bound(LatencyBuckets::COUNT - 1) == LatencyBuckets::MAX_VALUE);
+    CHECK(LatencyBuckets::index_of(UINT64_MAX) == LatencyBuckets::COUNT - 1);
+}
+
+TEST_CASE("latency histogram: reports quantiles of the recorded values") {
+    LatencyHistogram histogram{};
+    for (uint64_t value = 1; value <= 1000; value++) {
+        histogram.record(value);
+    }
+    histogram.record(1'000'000);
+
+    LatencyHistogramSnapshot snapshot{};
+    histogram.merge_into(snapshot);
+
+    CHECK(snapshot.count() == 1001);
+    CHECK(snapshot.sum() == 500'500 + 1'000'000);
+    CHECK(snapshot.value_at_quantile(0.0) == 1);
+    CHECK(snapshot.value_at_quantile(0.5) >= 501);
+    CHECK(snapshot.value_at_quantile(0.5) <= 501 + 501 / 32);
+    CHECK(snapshot.value_at_quantile(0.99) >= 991);
+    CHECK(snapshot.value_at_quantile(0.99) <= 991 + 991 / 32);
+    CHECK(snapshot.value_at_quantile(1.0) >= 1'000'000);
+    CHECK(snapshot.value_at_quantile(1.0) <= 1'000'000 + 1'000'000 / 32);
+    CHECK(snapshot.count_at_or_below(63) == 63);
+    CHECK(snapshot.count_at_or_below(10'000) == 1000);
+
+    SECTION ("empty histograms report zero") {
+        CHECK(LatencyHistogramSnapshot{}.value_at_quantile(0.99) == 0);
+    }
+}
+
+TEST_CASE("latency histogram: snapshots merge histograms from several threads") {
+    LatencyHistogram first{};
+    LatencyHistogram second{};
+    std::thread writer{[&second] {
+        for (int i = 0; i < 100; i++) {
+            second.record(2000);
+        }
+    }};
+    for (int i = 0; i < 100; i++) {
+        first.record(10);
+    }
+    writer.join();
+
+    LatencyHistogramSnapshot snapshot{};
+    first.merge_into(snapshot);
+    second.merge_into(snapshot);
+
+    CHECK(snapshot.count() == 200);
+    CHECK(snapshot.value_at_quantile(0.5) == 10);
+    CHECK(snapshot.value_at_quantile(0.51) >= 2000);
+}
@@ -0,0 +1,60 @@
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+
+#include "latency_histogram.h"
+#include "prometheus_text.h"
+
+using ion::PrometheusLabel;
+using ion::PrometheusTextWriter;
+
+static std::string_view as_text(const std::vector<uint8_t>& out) {
+    return {reinterpret_cast<const char*>(out.data()), out.size()};
+}
+
+TEST_CASE("prometheus text: writes families and labelled samples") {
+    std::vector<uint8_t> out{};
+    PrometheusTextWriter writer{out};
+
+    writer.header("ion_requests_total", "counter", "Requests served");
+    const std::array labels{PrometheusLabel{"code", "200"}, PrometheusLabel{"path", "a\"b\\c\n"}};
+    writer.sample("ion_requests_total", uint64_t{12}, labels);
+    writer.sample("ion_connections", int64_t{-1});
+    writer.sample("ion_uptime_seconds", 1.5);
+
+    CHECK(as_text(out) == "# HELP ion_requests_total Requests served\n"
+                 "# TYPE ion_requests_total counter\n"
+                 "ion_requests_total{code=\"200\",path=\"a\\\"b\\\\c\\n\"} 12\n"
+                 "ion_connections -1\n"
+                 "ion_uptime_seconds 1.5\n");
+}
+
+TEST_CASE("prometheus text: writes cumulative histogram buckets in seconds") {
+    ion::LatencyHistogram histogram{};
+    histogram.record(50);
+    histogram.record(400);
+    histogram.record(400);
+    histogram.record(3'000'000);
+    ion::LatencyHistogramSnapshot snapshot{};
+    histogram.merge_into(snapshot);
+
+    std::vector<uint8_t> out{};
+    PrometheusTextWriter writer{out};
+    const std::array<uint64_t, 3> bounds{100, 500, 1'000'000};
+    writer.histogram_seconds("ion_duration_seconds", "Durations", snapshot, bounds);
+
+    CHECK(as_text(out) == "# HELP ion_duration_seconds Durations\n"
+                 "# TYPE ion_duration_seconds histogram\n"
+                 "ion_duration_seconds_bucket{le=\"0.0001\"} 1\n"
+                 "ion_duration_seconds_bucket{le=\"0.0005\"} 3\n"
+                 "ion_duration_seconds_bucket{le=\"1\"} 3\n"
+                 "ion_duration_seconds_bucket{le=\"+Inf\"} 4\n"
+                 "ion_duration_seconds_sum 3.00085\n"
+                 "ion_duration_seconds_count 4\n");
+
+    SECTION ("reuses the buffer's capacity") {
+        const auto* data = out.data();
+        out.clear();
+        writer.histogram_seconds("ion_duration_seconds", "Durations", snapshot, bounds);
+        CHECK(out.data() == data);
+    }
+}
@@ -0,0 +1,28 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "request_sampler.h"
+
+using ion::RequestSampler;
+
+static int count_sampled(const RequestSampler& sampler, int requests) {
+    int sampled = 0;
+    for (int i = 0; i < requests; i++) {
+        sampled += sampler.sample() ? 1 : 0;
+    }
+    return sampled;
+}
+
+TEST_CASE("request sampler: samples the configured fraction of requests") {
+    CHECK(count_sampled(RequestSampler{1.0}, 1000) == 1000);
+    CHECK(count_sampled(RequestSampler{0.0}, 1000) == 0);
+
+    const auto sampled = count_sampled(RequestSampler{0.25}, 100'000);
+    CHECK(sampled > 24'000);
+    CHECK(sampled < 26'000);
+}
+
+TEST_CASE("request sampler: clamps out of range ratios") {
+    CHECK(RequestSampler{2.0}.ratio() == 1.0);
+    CHECK(RequestSampler{-1.0}.ratio() == 0.0);
+    CHECK(count_sampled(RequestSampler{-1.0}, 100) == 0);
+}
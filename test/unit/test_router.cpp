@@ -1,3 +1,5 @@
+#include <format>
+
 #include "catch2/catch_test_macros.hpp"
 #include "router.h"
 
@@ -35,3 +37,125 @@ TEST_CASE("router: returns appropriate handler function") {
         REQUIRE(handler(dummy_req).status_code == 202);
     }
 }
+
+TEST_CASE("router: matches path parameters and wildcards") {
+    auto router = ion::Router{};
+    auto dummy_req = ion::HttpRequest{};
+
+    router.add_route("/users/:id", "GET", [](auto&) { return ion::HttpResponse{200}; });
+    router.add_route("/users/new", "GET", [](auto&) { return ion::HttpResponse{201}; });
+    router.add_route("/users/:id/posts/:post", "GET", [](auto&) { return ion::HttpResponse{202}; });
+    router.add_route("/files/*rest", "GET", [](auto&) { return ion::HttpResponse{203}; });
+    router.add_route("/users/:id", "DELETE", [](auto&) { return ion::HttpResponse{204}; });
+
+    SECTION ("captures a single segment") {
+        auto match = router.match("/users/42", "GET");
+
+        REQUIRE(match.handler(dummy_req).status_code == 200);
+        REQUIRE(match.params.size() == 1);
+        REQUIRE(match.params[0].name == "id");
+        REQUIRE(match.params[0].value == "42");
+    }
+
+    SECTION ("prefers static segments over parameters") {
+        auto match = router.match("/users/new", "GET");
+
+        REQUIRE(match.handler(dummy_req).status_code == 201);
+        REQUIRE(match.params.empty());
+    }
+
+    SECTION ("captures multiple parameters") {
+        auto match = router.match("/users/new/posts/7", "GET");
+        auto req = ion::HttpRequest{.params = match.params};
+
+        REQUIRE(match.handler(dummy_req).status_code == 202);
+        REQUIRE(req.param("id") == "new");
+        REQUIRE(req.param("post") == "7");
+        REQUIRE_FALSE(req.param("missing"));
+    }
+
+    SECTION ("captures the rest of the path with a wildcard") {
+        auto match = router.match("/files/css/site.css", "GET");
+
+        REQUIRE(match.handler(dummy_req).status_code == 203);
+        REQUIRE(match.params[0].name == "rest");
+        REQUIRE(match.params[0].value == "css/site.css");
+    }
+
+    SECTION ("reports the matching route pattern") {
+        REQUIRE(router.match("/users/new/posts/7", "GET").route == "/users/:id/posts/:post");
+        REQUIRE(router.match("/files/a.txt", "GET").route == "/files/*rest");
+        REQUIRE(router.match("/nothing", "GET").route.empty());
+
+        auto req = ion::HttpRequest{.method = ion::HttpMethod::Delete, .path = "/users/9?x=1"};
+        REQUIRE(router.dispatch(req).status_code == 204);
+        REQUIRE(req.route == "/users/:id");
+    }
+
+    SECTION ("dispatches on method") {
+        REQUIRE(router.get_handler("/users/1", "DELETE")(dummy_req).status_code == 204);
+        REQUIRE(router.get_handler("/users/1", "POST")(dummy_req).status_code == 404);
+    }
+
+    SECTION ("does not match partial segments") {
+        REQUIRE(router.get_handler("/users", "GET")(dummy_req).status_code == 404);
+        REQUIRE(router.get_handler("/users/", "GET")(dummy_req).status_code == 404);
+        REQUIRE(router.get_handler("/users/1/posts", "GET")(dummy_req).status_code == 404);
+    }
+
+    SECTION ("ignores the query string") {
+        REQUIRE(router.get_handler("/users/new?ref=home", "GET")(dummy_req).status_code == 201);
+    }
+
+    SECTION ("rejects conflicting parameter names") {
+        REQUIRE_THROWS_AS(
+            router.add_route("/users/:name", "PUT", [](auto&) { return ion::HttpResponse{200}; }),
+            std::invalid_argument);
+    }
+}
+
+TEST_CASE("router: splits shared prefixes across many routes") {
+    auto router = ion::Router{};
+    auto dummy_req = ion::HttpRequest{};
+
+    for (uint16_t i = 0; i < 300; i++) {
+        router.add_route(std::format("/api/v1/resource{}", i), "GET",
+                         [i](auto&) { return ion::HttpResponse{i}; });
+    }
+
+    for (uint16_t i = 0; i < 300; i++) {
+        REQUIRE(router.get_handler(std::format("/api/v1/resource{}", i), "GET")(dummy_req)
+                    .status_code == i);
+    }
+    REQUIRE(router.get_handler("/api/v1/resource300", "GET")(dummy_req).status_code == 404);
+    REQUIRE(router.get_handler("/api/v1/resource", "GET")(dummy_req).status_code == 404);
+}
+
+TEST_CASE("router: dispatches on method enum") {
+    auto router = ion::Router{};
+    auto dummy_req = ion::HttpRequest{};
+
+    router.add_route("/items", ion::HttpMethod::Put, [](auto&) { return ion::HttpResponse{200}; });
+    router.add_route("/items", "PROPFIND", [](auto&) { return ion::HttpResponse{207}; });
+
+    REQUIRE(router.match("/items", ion::HttpMethod::Put).handler(dummy_req).status_code == 200);
+    REQUIRE(router.get_handler("/items", "PUT")(dummy_req).status_code == 200);
+    REQUIRE(router.match("/items", ion::HttpMethod::Other, "PROPFIND").handler(dummy_req)
+                .status_code == 207);
+    REQUIRE(router.match("/items", ion::HttpMethod::Other, "MKCOL").handler(dummy_req)
+                .status_code == 404);
+}
+
+TEST_CASE("router: prefers the longest matching static mount") {
+    auto router = ion::Router{};
+
+    // neither the first nor the last registered match is the longest for every path below
+    router.add_static_handler(std::make_unique<ion::StaticFileHandler>("/static/img", "."));
+    router.add_static_handler(std::make_unique<ion::StaticFileHandler>("/static", "."));
+    router.add_static_handler(std::make_unique<ion::StaticFileHandler>("/static/img/icons", "."));
+
+    REQUIRE(router.match("/static/img/icons/a.png", "GET").route == "/static/img/icons");
+    REQUIRE(router.match("/static/img/a.png", "GET").route == "/static/img");
+    REQUIRE(router.match("/static/site.css", "GET").route == "/static");
+    REQUIRE(router.match("/static/img/a.png", "POST").route.empty());
+}
@@ -40,3 +40,39 @@ TEST_CASE("router: middleware support") {
         REQUIRE(handler(dummy_req).status_code == 201);
     }
 }
+
+TEST_CASE("router: composes middleware at registration") {
+    auto router = ion::Router{};
+    auto dummy_req = ion::HttpRequest{};
+    int compositions = 0;
+
+    router.add_route("/foo", "GET", [](auto&) { return ion::HttpResponse{.status_code = 200}; });
+    router.add_middleware([&compositions](auto next) {
+        compositions++;
+        return [next](const auto& req) {
+            auto res = next(req);
+            res.status_code += 1;
+            return res;
+        };
+    });
+    const auto compositions_after_registration = compositions;
+
+    SECTION ("applies middleware added after the route") {
+        REQUIRE(router.get_handler("/foo", "GET")(dummy_req).status_code == 201);
+        REQUIRE(router.get_handler("/bar", "GET")(dummy_req).status_code == 405);
+    }
+
+    SECTION ("does not rebuild the chain per request") {
+        const auto& first = router.get_handler("/foo", "GET");
+        const auto& second = router.get_handler("/foo", "GET");
+
+        REQUIRE(&first == &second);
+        REQUIRE(compositions == compositions_after_registration);
+    }
+
+    SECTION ("composes routes added after the middleware") {
+        router.add_route("/baz", "GET", [](auto&) { return ion::HttpResponse{.status_code = 300}; });
+
+        REQUIRE(router.get_handler("/baz", "GET")(dummy_req).status_code == 301);
+    }
+}
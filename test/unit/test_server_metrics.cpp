@@ -0,0 +1,72 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thread>
+
+#include "server_metrics.h"
+
+using ion::ConnectionMetrics;
+using ion::ServerMetrics;
+
+TEST_CASE("server metrics: connections add to their thread's gauges until destroyed") {
+    const auto before = ServerMetrics::snapshot();
+    {
+        ConnectionMetrics first{};
+        ConnectionMetrics second{};
+        first.set_active_streams(3);
+        first.set_active_streams(2);
+        second.set_active_streams(1);
+        first.set_hpack_table_sizes(100, 40);
+        first.set_hpack_table_sizes(64, 80);
+        first.add_received(10);
+        second.add_sent(25);
+
+        const auto during = ServerMetrics::snapshot();
+        CHECK(during.active_connections == before.active_connections + 2);
+        CHECK(during.active_streams == before.active_streams + 3);
+        CHECK(during.hpack_decoder_table_bytes == before.hpack_decoder_table_bytes + 64);
+        CHECK(during.hpack_encoder_table_bytes == before.hpack_encoder_table_bytes + 80);
+        CHECK(during.bytes_received == before.bytes_received + 10);
+        CHECK(during.bytes_sent == before.bytes_sent + 25);
+    }
+
+    // gauges are given back; byte counters are cumulative
+    const auto after = ServerMetrics::snapshot();
+    CHECK(after.active_connections == before.active_connections);
+    CHECK(after.active_streams == before.active_streams);
+    CHECK(after.hpack_decoder_table_bytes == before.hpack_decoder_table_bytes);
+    CHECK(after.hpack_encoder_table_bytes == before.hpack_encoder_table_bytes);
+    CHECK(after.bytes_received == before.bytes_received + 10);
+    CHECK(after.bytes_sent == before.bytes_sent + 25);
+}
+
+TEST_CASE("server metrics: snapshot sums the counters of every thread") {
+    const auto before = ServerMetrics::snapshot();
+
+    std::thread worker{[] {
+        ConnectionMetrics conn{};
+        conn.add_received(7);
+        conn.add_sent(9);
+    }};
+    worker.join();
+    ServerMetrics::local().bytes_received.fetch_add(1);
+
+    const auto after = ServerMetrics::snapshot();
+    CHECK(after.bytes_received == before.bytes_received + 8);
+    CHECK(after.bytes_sent == before.bytes_sent + 9);
+    CHECK(after.active_connections == before.active_connections);
+}
+
+TEST_CASE("server metrics: counts responses by status code with their latency") {
+    const auto before = ServerMetrics::request_snapshot();
+
+    ServerMetrics::record_request("/a", 200, std::chrono::milliseconds{2});
+    ServerMetrics::record_request("", 404, std::chrono::microseconds{50});
+    ServerMetrics::record_request("/a", 999, std::chrono::milliseconds{1});
+
+    const auto after = ServerMetrics::request_snapshot();
+    CHECK(after.total_requests == before.total_requests + 3);
+    CHECK(after.status_codes[200] == before.status_codes[200] + 1);
+    CHECK(after.status_codes[404] == before.status_codes[404] + 1);
+    // codes out of range are counted as other
+    CHECK(after.status_codes[0] == before.status_codes[0] + 1);
+    CHECK(after.latency.sum() - before.latency.sum() == 3050);
+}
@@ -0,0 +1,136 @@
+#include <unistd.h>
+
+#include <catch2/catch_all.hpp>
+#include <filesystem>
+#include <fstream>
+
+#include "static_file_cache.h"
+#include "static_file_handler.h"
+
+using ion::CachedFile;
+using ion::FileStamp;
+using ion::StaticFileCache;
+using ion::StaticFileCacheConfig;
+using namespace std::chrono_literals;
+
+namespace fs = std::filesystem;
+
+static void write_file(const fs::path& path, const std::string& text) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << text;
+}
+
+static CachedFile cached_file(const fs::path& path, size_t size) {
+    return CachedFile{.path = path.string(),
+                      .mime_type = "text/plain; charset=utf-8",
+                      .content = std::make_shared<const std::vector<uint8_t>>(size, 'x'),
+                      .stamp = FileStamp::of(path.string()).value()};
+}
+
+TEST_CASE("static file cache: evicts least recently used entries within budget") {
+    auto base = fs::temp_directory_path() / ("ion_file_cache_" + std::to_string(::getpid()));
+    fs::create_directories(base);
+    write_file(base / "a.txt", "a");
+
+    const auto now = StaticFileCache::Clock::now();
+    StaticFileCache cache{{.max_bytes = 30, .max_entry_bytes = 20}};
+    const auto file = base / "a.txt";
+
+    cache.insert("a", cached_file(file, 10), now);
+    cache.insert("b", cached_file(file, 10), now);
+    REQUIRE(cache.find("a", now) != nullptr);  // "b" is now least recently used
+    cache.insert("c", cached_file(file, 15), now);
+
+    CHECK(cache.find("a", now) != nullptr);
+    CHECK(cache.find("b", now) == nullptr);
+    CHECK(cache.find("c", now) != nullptr);
+    CHECK(cache.size_bytes() == 25);
+    CHECK(cache.count() == 2);
+    CHECK(cache.evictions() == 1);
+
+    SECTION ("entries over the per-entry limit are not cached") {
+        cache.insert("big", cached_file(file, 21), now);
+        CHECK(cache.find("big", now) == nullptr);
+        CHECK(cache.size_bytes() == 25);
+    }
+
+    SECTION ("replacing an entry releases its budget") {
+        cache.insert("a", cached_file(file, 5), now);
+        CHECK(cache.size_bytes() == 20);
+        CHECK(cache.count() == 2);
+    }
+
+    fs::remove_all(base);
+}
+
+TEST_CASE("static file cache: revalidates entries against the filesystem") {
+    auto base = fs::temp_directory_path() / ("ion_file_cache_" + std::to_string(::getpid()));
+    fs::create_directories(base);
+    const auto file = base / "a.txt";
+    write_file(file, "first");
+
+    const auto now = StaticFileCache::Clock::now();
+    StaticFileCache cache{{.revalidate_interval = 1s}};
+    cache.insert("a", cached_file(file, 5), now);
+    write_file(file, "changed");
+
+    // within the interval the entry is trusted without a stat
+    CHECK(cache.find("a", now + 999ms) != nullptr);
+    CHECK(cache.find("a", now + 1s) == nullptr);
+    CHECK(cache.count() == 0);
+
+    fs::remove_all(base);
+}
+
+TEST_CASE("static file handler: serves repeat requests from the cache") {
+    auto base = fs::temp_directory_path() / ("ion_file_cache_" + std::to_string(::getpid()));
+    fs::create_directories(base);
+    write_file(base / "index.html", "<p>hello</p>");
+
+    ion::StaticFileHandler handler{"/static", base.string(), {.revalidate_interval = 1h}};
+
+    const auto first = handler.handle("/static/index.html", false);
+    REQUIRE(first.status_code == 200);
+    CHECK(handler.cache().count() == 1);
+
+    fs::remove(base / "index.html");
+
+    const auto second = handler.handle("/static/index.html", false);
+    CHECK(second.status_code == 200);
+    // both point at the cached buffer rather than holding copies
+    REQUIRE(second.shared_body);
+    CHECK(second.shared_body == first.shared_body);
+    CHECK(second.body.empty());
+    CHECK(second.body_size() == 12);
+    CHECK(second.pre_encoded_headers == first.pre_encoded_headers);
+
+    const auto head = handler.handle("/static/index.html?v=2", true);
+    CHECK(head.status_code == 200);
+    CHECK(head.body.empty());
+    REQUIRE(head.headers.size() == 1);
+    CHECK(head.headers[0].value == "12");
+    CHECK(handler.cache().hits() == 2);
+
+    CHECK(handler.handle("/static/missing.html", false).status_code == 404);
+    CHECK(handler.cache().count() == 1);
+
+    fs::remove_all(base);
+}
+
+TEST_CASE("static file handler: streams files too large to cache") {
+    auto base = fs::temp_directory_path() / ("ion_file_cache_" + std::to_string(::getpid()));
+    fs::create_directories(base);
+    write_file(base / "large.bin", std::string(64, 'z'));
+
+    ion::StaticFileHandler handler{"/static", base.string(), {.max_entry_bytes = 32}};
+
+    const auto res = handler.handle("/static/large.bin", false);
+    CHECK(res.status_code == 200);
+    CHECK(res.body.empty());
+    REQUIRE(res.file_body);
+    CHECK(res.file_body->length() == 64);
+    CHECK(res.body_size() == 64);
+    CHECK(handler.cache().count() == 0);
+
+    fs::remove_all(base);
+}
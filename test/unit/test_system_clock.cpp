@@ -0,0 +1,32 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <string>
+
+#include "system_clock.h"
+
+using namespace std::chrono_literals;
+
+TEST_CASE("system clock: formats http dates") {
+    // 784111777 is Sun, 06 Nov 1994 08:49:37 GMT, the example from RFC 9110
+    const auto time = std::chrono::system_clock::from_time_t(784111777);
+
+    CHECK(SystemClock::http_date(time) == "Sun, 06 Nov 1994 08:49:37 GMT");
+    CHECK(SystemClock::http_date(time + 999ms) == "Sun, 06 Nov 1994 08:49:37 GMT");
+    CHECK(SystemClock::http_date(time + 1s) == "Sun, 06 Nov 1994 08:49:38 GMT");
+    CHECK(SystemClock::http_date(time) == "Sun, 06 Nov 1994 08:49:37 GMT");
+}
+
+TEST_CASE("system clock: formats common log format timestamps") {
+    const auto time = std::chrono::system_clock::from_time_t(784111777);
+
+    // the offset depends on the local timezone
+    const std::string first{SystemClock::clf_timestamp(time)};
+    CHECK(first.size() == 28);
+    CHECK(first.front() == '[');
+    CHECK(first.back() == ']');
+    CHECK(first.find("/Nov/1994:") != std::string::npos);
+
+    const std::string next{SystemClock::clf_timestamp(time + 1s)};
+    CHECK(next != first);
+    CHECK(SystemClock::clf_timestamp(time) == first);
+}
@@ -0,0 +1,54 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "transports/ticket_key_ring.h"
+
+using ion::TicketKeyRing;
+using namespace std::chrono_literals;
+
+TEST_CASE("ticket key ring: rotates keys and retires old ones") {
+    const auto start = TicketKeyRing::Clock::now();
+    TicketKeyRing ring{1h, start};
+    const auto first = ring.current();
+
+    SECTION ("keeps the current key until the interval elapses") {
+        ring.rotate_if_due(start + 59min);
+        REQUIRE(ring.current().name == first.name);
+        REQUIRE(ring.rotations() == 0);
+    }
+
+    SECTION ("keeps the previous key for decrypting after a rotation") {
+        ring.rotate_if_due(start + 1h);
+        REQUIRE(ring.rotations() == 1);
+        REQUIRE(ring.current().name != first.name);
+        REQUIRE(ring.current().aes_key != first.aes_key);
+
+        const auto* previous = ring.find(first.name);
+        REQUIRE(previous != nullptr);
+        REQUIRE(previous->hmac_key == first.hmac_key);
+    }
+
+    SECTION ("retires keys after two rotations") {
+        ring.rotate(start + 1h);
+        ring.rotate(start + 2h);
+        REQUIRE(ring.find(first.name) == nullptr);
+        REQUIRE(ring.find(ring.current().name) == &ring.current());
+    }
+}
+
+TEST_CASE("ticket key ring: retires keys when only decrypting") {
+    const auto start = TicketKeyRing::Clock::now();
+    TicketKeyRing ring{1h, start};
+    const auto first = ring.current();
+
+    // no new tickets are sealed in between, as when every client resumes
+    REQUIRE(ring.decryption_key(first.name, start + 59min) != nullptr);
+    REQUIRE(ring.decryption_key(first.name, start + 1h) != nullptr);
+    REQUIRE(ring.rotations() == 1);
+    REQUIRE(ring.decryption_key(first.name, start + 2h) == nullptr);
+    REQUIRE(ring.rotations() == 2);
+
+    // new tickets are sealed with whatever key is newest
+    const auto& key = ring.encryption_key(start + 3h);
+    REQUIRE(ring.rotations() == 3);
+    REQUIRE(&key == &ring.current());
+}
@@ -0,0 +1,52 @@
+#include <opentelemetry/trace/context.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+#include "trace_parent.h"
+
+using ion::HttpHeader;
+using ion::TraceParent;
+
+static std::string trace_id_of(const TraceParent& parent) {
+    char trace_id[32];
+    opentelemetry::trace::GetSpan(parent.context)->GetContext().trace_id().ToLowerBase16(trace_id);
+    return {trace_id, sizeof(trace_id)};
+}
+
+TEST_CASE("trace parent: extracted from W3C traceparent headers") {
+    const std::string trace_id{"4bf92f3577b34da6a3ce929d0e0e4736"};
+
+    SECTION ("sampled parent") {
+        const auto parent = TraceParent::extract(
+            {{"user-agent", "test"}, {"traceparent", "00-" + trace_id + "-00f067aa0ba902b7-01"}});
+        REQUIRE(parent);
+        CHECK(parent->sampled);
+        CHECK(trace_id_of(*parent) == trace_id);
+    }
+
+    SECTION ("unsampled parent") {
+        const auto parent =
+            TraceParent::extract({{"traceparent", "00-" + trace_id + "-00f067aa0ba902b7-00"}});
+        REQUIRE(parent);
+        CHECK_FALSE(parent->sampled);
+    }
+
+    SECTION ("no traceparent") {
+        CHECK_FALSE(TraceParent::extract({{"user-agent", "test"}}));
+    }
+
+    SECTION ("invalid traceparent") {
+        CHECK_FALSE(TraceParent::extract({{"traceparent", "not-a-trace"}}));
+        CHECK_FALSE(TraceParent::extract(
+            {{"traceparent", "00-00000000000000000000000000000000-00f067aa0ba902b7-01"}}));
+    }
+}
+
+TEST_CASE("trace parent: header carrier looks up request headers") {
+    const std::vector<HttpHeader> headers{{"tracestate", "vendor=value"}};
+    const ion::HttpHeaderCarrier carrier{headers};
+
+    CHECK(carrier.Get("tracestate") == "vendor=value");
+    CHECK(carrier.Get("traceparent").empty());
+}
@@ -0,0 +1,129 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <CLI/App.hpp>
+#include <CLI/Config.hpp>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "access_log_binary.h"
+
+// Converts a binary access log (--access-log-format binary) back to Combined Log Format lines
+// or JSON objects, one per line.
+
+static constexpr size_t READ_SIZE = 1024 * 1024;
+
+static void append_json_string(std::string_view value, std::string& out) {
+    out.push_back('"');
+    for (const char c : value) {
+        switch (c) {
+            case '"':
+                out.append("\\\"");
+                break;
+            case '\\':
+                out.append("\\\\");
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    std::format_to(std::back_inserter(out), "\\u{:04x}", c);
+                } else {
+                    out.push_back(c);
+                }
+        }
+    }
+    out.push_back('"');
+}
+
+static void format_json(const ion::AccessLogRecord& record, std::string& out) {
+    std::format_to(std::back_inserter(out), R"({{"time":"{:%FT%T}Z","client_ip":)",
+                   std::chrono::floor<std::chrono::milliseconds>(record.time));
+    append_json_string(record.client_ip.view(), out);
+    out.append(R"(,"method":)");
+    append_json_string(record.method.view(), out);
+    out.append(R"(,"path":)");
+    append_json_string(record.path.view(), out);
+    std::format_to(std::back_inserter(out), R"(,"status":{},"bytes":{},"referrer":)",
+                   record.status_code, record.content_length);
+    append_json_string(record.referrer.view(), out);
+    out.append(R"(,"user_agent":)");
+    append_json_string(record.user_agent.view(), out);
+    out.append("}\n");
+}
+
+static bool write_out(std::string& text) {
+    const bool ok = std::fwrite(text.data(), 1, text.size(), stdout) == text.size();
+    text.clear();
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    CLI::App app{"ion-logcat: converts binary ion access logs to text"};
+    std::string path{"-"};
+    std::string format{"clf"};
+    app.add_option("file", path, "Binary access log to read, or - for stdin")->default_val("-");
+    app.add_option("--format,-f", format, "Output format")
+        ->default_val("clf")
+        ->check(CLI::IsMember({"clf", "json"}, CLI::ignore_case));
+    try {
+        app.parse(argc, argv);
+    } catch (const CLI::ParseError& e) {
+        return app.exit(e);
+    }
+
+    const int fd = path == "-" ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::fprintf(stderr, "ion-logcat: %s: %s\n", path.c_str(), strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    const auto formatter = format == "json" ? format_json : ion::AccessLog::format_clf;
+    ion::BinaryAccessLogDecoder decoder{};
+    std::vector<uint8_t> buffer{};
+    std::string text{};
+    const auto on_record = [&](const ion::AccessLogRecord& record) { formatter(record, text); };
+
+    while (true) {
+        const auto filled = buffer.size();
+        buffer.resize(filled + READ_SIZE);
+        const auto count = ::read(fd, buffer.data() + filled, READ_SIZE);
+        if (count < 0 && errno == EINTR) {
+            buffer.resize(filled);
+            continue;
+        }
+        if (count < 0) {
+            std::fprintf(stderr, "ion-logcat: %s: %s\n", path.c_str(), strerror(errno));
+            return EXIT_FAILURE;
+        }
+        buffer.resize(filled + static_cast<size_t>(count));
+        const bool at_end = count == 0;
+
+        const auto consumed = decoder.decode(buffer, on_record, at_end);
+        if (!consumed) {
+            std::fprintf(stderr, "ion-logcat: %s: not a valid binary access log\n", path.c_str());
+            return EXIT_FAILURE;
+        }
+        buffer.erase(buffer.begin(), buffer.begin() + static_cast<ptrdiff_t>(*consumed));
+        if (!write_out(text)) {
+            return EXIT_FAILURE;
+        }
+        if (at_end) {
+            break;
+        }
+    }
+
+    if (const auto skipped = decoder.skipped_bytes(); skipped != 0) {
+        std::fprintf(stderr, "ion-logcat: %s: skipped %llu bytes of damaged data\n", path.c_str(),
+                     static_cast<unsigned long long>(skipped));
+    }
+    if (!buffer.empty()) {
+        std::fprintf(stderr, "ion-logcat: %s: ignoring %zu bytes of truncated data\n",
+                     path.c_str(), buffer.size());
+    }
+    return EXIT_SUCCESS;
+}